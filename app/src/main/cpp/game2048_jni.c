@@ -1,33 +1,64 @@
 #include <jni.h>
 #include <string.h>
-#include <stdlib.h>
-#include <time.h>
+#include <pthread.h>
 #include "game2048.h"
+#include "game2048_session.h"
 
-// 全局游戏状态对象
-static GameState gameState;
-static bool is_initialized = false;
+// 每个Game2048对象对应一个会话（game2048_session.h），Java侧持有句柄。
+// 后台搜索的转置表大小由Java侧在创建时指定，首次后台搜索时才分配，release()时连同后台线程一起释放
 
-// 初始化游戏
+// pollAISearch的返回值，与Game2048.java中的AI_SEARCH_*常量一致；其余为方向
+#define AI_SEARCH_NONE (-1)         // 没有结果：未提交、已取消、无法移动或棋盘已改变
+#define AI_SEARCH_RUNNING (-2)      // 搜索仍在进行
+
+// getLastSearchStats返回数组的布局，与Game2048.java中的STAT_*常量一致
+enum {
+    STAT_MOVES_EVALED,
+    STAT_HEURISTIC_EVALS,
+    STAT_CPROB_PRUNES,
+    STAT_DEPTH_CUTOFFS,
+    STAT_TT_PROBES,
+    STAT_TT_HITS,
+    STAT_TT_EVICTIONS,
+    STAT_TT_COLLISIONS,
+    STAT_MAX_DEPTH,
+    STAT_ELAPSED_US,
+    STAT_CHANCE_NODES,                                      // 之后依次为各层机会节点数
+    STAT_MOVE_NODES = STAT_CHANCE_NODES + SEARCH_STATS_DEPTHS,  // 之后依次为各层max节点数
+    STAT_COUNT = STAT_MOVE_NODES + SEARCH_STATS_DEPTHS
+};
+
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+// 创建会话，返回句柄；tableSize为后台搜索的转置表槽位数，0表示不后台搜索；失败时返回0
+JNIEXPORT jlong JNICALL
+Java_com_example_game2048_Game2048_nativeCreate(JNIEnv *env, jclass cls, jlong seed, jint tableSize) {
+    // 初始化游戏表格，只需一次
+    pthread_once(&tables_once, init_tables);
+    return (jlong)session_create((uint64_t)seed, tableSize > 0 ? (size_t)tableSize : 0);
+}
+
+// 销毁会话，取消其后台搜索
 JNIEXPORT void JNICALL
-Java_com_example_game2048_Game2048_initGame(JNIEnv *env, jobject thisObj) {
-    if (!is_initialized) {
-        // 初始化随机数种子
-        srand(time(NULL));
-        // 初始化游戏表格
-        init_tables();
-        is_initialized = true;
-    }
-    
-    // 初始化游戏状态
-    init_game(&gameState);
+Java_com_example_game2048_Game2048_nativeDestroy(JNIEnv *env, jclass cls, jlong session) {
+    session_destroy((GameSession)session);
+}
+
+// 重新开局，保留最高分
+JNIEXPORT void JNICALL
+Java_com_example_game2048_Game2048_nativeReset(JNIEnv *env, jclass cls, jlong session) {
+    session_reset((GameSession)session);
 }
 
 // 获取棋盘状态
 JNIEXPORT jintArray JNICALL
-Java_com_example_game2048_Game2048_getBoard(JNIEnv *env, jobject thisObj) {
+Java_com_example_game2048_Game2048_nativeGetBoard(JNIEnv *env, jclass cls, jlong session) {
+    GameState state;
+    if (!session_get_state((GameSession)session, &state)) {
+        memset(&state, 0, sizeof(state));
+    }
     int grid[BOARD_SIZE][BOARD_SIZE];
-    board_to_grid(gameState.board, grid);
+    board_to_grid(state.board, grid);
     
     // 创建一维数组返回给Java
     jintArray result = (*env)->NewIntArray(env, BOARD_SIZE * BOARD_SIZE);
@@ -49,51 +80,116 @@ Java_com_example_game2048_Game2048_getBoard(JNIEnv *env, jobject thisObj) {
     return result;
 }
 
-// 执行移动
+// 获取打包的64位棋盘：每格4位存砖块等级（0为空），第row行第col列位于(row*4+col)*4位起。
+// 不分配Java对象，适合每帧调用
+JNIEXPORT jlong JNICALL
+Java_com_example_game2048_Game2048_nativeGetPackedBoard(JNIEnv *env, jclass cls, jlong session) {
+    GameState state;
+    return session_get_state((GameSession)session, &state) ? (jlong)state.board : 0;
+}
+
+// 执行移动，棋盘改变时落下新砖块
 JNIEXPORT jboolean JNICALL
-Java_com_example_game2048_Game2048_move(JNIEnv *env, jobject thisObj, jint direction) {
+Java_com_example_game2048_Game2048_nativeMove(JNIEnv *env, jclass cls, jlong session, jint direction) {
     bool moved = false;
-    
-    switch (direction) {
-        case UP:
-            moved = move_up(&gameState);
-            break;
-        case DOWN:
-            moved = move_down(&gameState);
-            break;
-        case LEFT:
-            moved = move_left(&gameState);
-            break;
-        case RIGHT:
-            moved = move_right(&gameState);
-            break;
-        default:
-            return JNI_FALSE;
-    }
-    
+    session_move((GameSession)session, direction, &moved);
     return moved ? JNI_TRUE : JNI_FALSE;
 }
 
 // 获取当前分数
 JNIEXPORT jint JNICALL
-Java_com_example_game2048_Game2048_getScore(JNIEnv *env, jobject thisObj) {
-    return gameState.score;
+Java_com_example_game2048_Game2048_nativeGetScore(JNIEnv *env, jclass cls, jlong session) {
+    GameState state;
+    return session_get_state((GameSession)session, &state) ? state.score : 0;
 }
 
 // 获取最高分数
 JNIEXPORT jint JNICALL
-Java_com_example_game2048_Game2048_getBestScore(JNIEnv *env, jobject thisObj) {
-    return gameState.best_score;
+Java_com_example_game2048_Game2048_nativeGetBestScore(JNIEnv *env, jclass cls, jlong session) {
+    GameState state;
+    return session_get_state((GameSession)session, &state) ? state.best_score : 0;
 }
 
-// 检查游戏是否结束
+// 检查游戏是否结束，句柄无效时视为结束
 JNIEXPORT jboolean JNICALL
-Java_com_example_game2048_Game2048_isGameOver(JNIEnv *env, jobject thisObj) {
-    return is_game_over(&gameState) ? JNI_TRUE : JNI_FALSE;
+Java_com_example_game2048_Game2048_nativeIsGameOver(JNIEnv *env, jclass cls, jlong session) {
+    GameState state;
+    if (!session_get_state((GameSession)session, &state)) {
+        return JNI_TRUE;
+    }
+    return is_game_over(&state) ? JNI_TRUE : JNI_FALSE;
 }
 
-// AI移动
+// AI移动：在调用线程中等待搜索完成，深度较大时会阻塞界面，界面中应使用startAISearch
 JNIEXPORT jint JNICALL
-Java_com_example_game2048_Game2048_getAIMove(JNIEnv *env, jobject thisObj, jint depth) {
-    return find_best_move(&gameState, depth);
+Java_com_example_game2048_Game2048_nativeGetAIMove(JNIEnv *env, jclass cls, jlong session, jint depth) {
+    int move = -1;
+    if (session_search_start((GameSession)session, depth, 0)) {
+        session_search_wait((GameSession)session);
+        session_search_poll((GameSession)session, &move);
+    }
+    return move;
+}
+
+// 在后台线程中为当前棋盘开始AI搜索，立即返回；取代尚未完成的搜索
+JNIEXPORT jboolean JNICALL
+Java_com_example_game2048_Game2048_nativeStartAISearch(JNIEnv *env, jclass cls, jlong session, jint depth) {
+    GameState state;
+    if (!session_get_state((GameSession)session, &state) || state.game_over) {
+        return JNI_FALSE;
+    }
+    return session_search_start((GameSession)session, depth, 0) ? JNI_TRUE : JNI_FALSE;
+}
+
+// 查询后台搜索，不阻塞：返回方向、AI_SEARCH_RUNNING或AI_SEARCH_NONE。
+// 结果只返回一次；搜索期间棋盘被改变（玩家移动或重新开局）时结果作废
+JNIEXPORT jint JNICALL
+Java_com_example_game2048_Game2048_nativePollAISearch(JNIEnv *env, jclass cls, jlong session) {
+    int move = -1;
+    switch (session_search_poll((GameSession)session, &move)) {
+        case ASYNC_SEARCH_RUNNING:
+            return AI_SEARCH_RUNNING;
+        case ASYNC_SEARCH_DONE:
+            return move;
+        default:
+            return AI_SEARCH_NONE;
+    }
+}
+
+// 取消后台搜索，不阻塞
+JNIEXPORT void JNICALL
+Java_com_example_game2048_Game2048_nativeCancelAISearch(JNIEnv *env, jclass cls, jlong session) {
+    session_search_cancel((GameSession)session);
+}
+
+// 最近一次AI搜索的统计，布局见STAT_*；还没有搜索过时全部为0
+JNIEXPORT jlongArray JNICALL
+Java_com_example_game2048_Game2048_nativeGetLastSearchStats(JNIEnv *env, jclass cls, jlong session) {
+    SearchStats stats;
+    if (!session_search_stats((GameSession)session, &stats)) {
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    jlong buffer[STAT_COUNT];
+    buffer[STAT_MOVES_EVALED] = (jlong)stats.moves_evaled;
+    buffer[STAT_HEURISTIC_EVALS] = (jlong)stats.heuristic_evals;
+    buffer[STAT_CPROB_PRUNES] = (jlong)stats.cprob_prunes;
+    buffer[STAT_DEPTH_CUTOFFS] = (jlong)stats.depth_cutoffs;
+    buffer[STAT_TT_PROBES] = (jlong)stats.tt_probes;
+    buffer[STAT_TT_HITS] = (jlong)stats.tt_hits;
+    buffer[STAT_TT_EVICTIONS] = (jlong)stats.tt_evictions;
+    buffer[STAT_TT_COLLISIONS] = (jlong)stats.tt_collisions;
+    buffer[STAT_MAX_DEPTH] = stats.maxdepth;
+    buffer[STAT_ELAPSED_US] = (jlong)(stats.elapsed_ms * 1000);
+    for (int d = 0; d < SEARCH_STATS_DEPTHS; d++) {
+        buffer[STAT_CHANCE_NODES + d] = (jlong)stats.chance_nodes[d];
+        buffer[STAT_MOVE_NODES + d] = (jlong)stats.move_nodes[d];
+    }
+
+    jlongArray result = (*env)->NewLongArray(env, STAT_COUNT);
+    if (result == NULL) {
+        return NULL; // 内存不足
+    }
+    (*env)->SetLongArrayRegion(env, result, 0, STAT_COUNT, buffer);
+    return result;
 } 
\ No newline at end of file
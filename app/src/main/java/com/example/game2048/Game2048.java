@@ -19,35 +19,146 @@ public class Game2048 {
     // 棋盘大小
     public static final int BOARD_SIZE = 4;
     
-    // 初始化游戏
-    public native void initGame();
+    // pollAISearch的返回值，其余为方向，与game2048_jni.c一致
+    public static final int AI_SEARCH_NONE = -1;        // 没有结果：未开始、已取消、无法移动或棋盘已改变
+    public static final int AI_SEARCH_RUNNING = -2;     // 搜索仍在进行
     
-    // 获取棋盘状态
-    public native int[] getBoard();
+    // getLastSearchStats返回数组的下标，与game2048_jni.c一致
+    public static final int STAT_MOVES_EVALED = 0;      // 执行的移动数
+    public static final int STAT_HEURISTIC_EVALS = 1;   // 叶子的启发式评估次数
+    public static final int STAT_CPROB_PRUNES = 2;      // 概率截断的机会节点
+    public static final int STAT_DEPTH_CUTOFFS = 3;     // 到达深度限制的节点
+    public static final int STAT_TT_PROBES = 4;         // 转置表查找次数
+    public static final int STAT_TT_HITS = 5;           // 转置表命中次数
+    public static final int STAT_TT_EVICTIONS = 6;      // 覆盖旧代条目
+    public static final int STAT_TT_COLLISIONS = 7;     // 淘汰当前代的其他棋盘
+    public static final int STAT_MAX_DEPTH = 8;         // 到达的最大深度
+    public static final int STAT_ELAPSED_US = 9;        // 搜索用时（微秒）
+    public static final int SEARCH_STATS_DEPTHS = 16;
+    public static final int STAT_CHANCE_NODES = 10;     // 起各层机会节点数，共SEARCH_STATS_DEPTHS项
+    public static final int STAT_MOVE_NODES = STAT_CHANCE_NODES + SEARCH_STATS_DEPTHS;  // 起各层max节点数
+    
+    // 后台AI搜索默认的转置表槽位数（约4MB），界面使用的浅层搜索用不满更大的表
+    public static final int DEFAULT_SEARCH_TABLE_SIZE = 1 << 18;
+    
+    // 本局的原生会话句柄，每个Game2048对象是一局独立的游戏
+    private long session;
+    
+    public Game2048() {
+        this(DEFAULT_SEARCH_TABLE_SIZE);
+    }
+    
+    // searchTableSize为后台AI搜索的转置表槽位数，首次startAISearch时才分配；0表示不使用后台搜索
+    public Game2048(int searchTableSize) {
+        session = nativeCreate(System.nanoTime(), searchTableSize);
+        if (session == 0) {
+            throw new OutOfMemoryError("无法创建游戏会话");
+        }
+    }
+    
+    // 释放原生会话及其后台搜索线程和转置表，之后不能再使用此对象；重复调用无效果
+    public void release() {
+        if (session != 0) {
+            nativeDestroy(session);
+            session = 0;
+        }
+    }
+    
+    // 初始化游戏（重新开局，保留最高分）
+    public void initGame() {
+        nativeReset(session);
+    }
+    
+    // 获取棋盘状态（每次分配新数组，绘制时应使用getPackedBoard）
+    public int[] getBoard() {
+        return nativeGetBoard(session);
+    }
+    
+    // 获取打包的64位棋盘，每格4位存砖块等级，用getTileRank/getTileValue解码；不分配对象
+    public long getPackedBoard() {
+        return nativeGetPackedBoard(session);
+    }
+    
+    // 打包棋盘中第row行第col列的砖块等级，0为空，否则砖块值为2^等级
+    public static int getTileRank(long board, int row, int col) {
+        return (int) ((board >>> ((row * BOARD_SIZE + col) * 4)) & 0xf);
+    }
+    
+    // 打包棋盘中第row行第col列的砖块值，0为空
+    public static int getTileValue(long board, int row, int col) {
+        int rank = getTileRank(board, row, col);
+        return rank > 0 ? 1 << rank : 0;
+    }
     
     // 移动操作
-    public native boolean move(int direction);
+    public boolean move(int direction) {
+        return nativeMove(session, direction);
+    }
     
     // 获取当前分数
-    public native int getScore();
+    public int getScore() {
+        return nativeGetScore(session);
+    }
     
     // 获取最高分数
-    public native int getBestScore();
+    public int getBestScore() {
+        return nativeGetBestScore(session);
+    }
     
     // 检查游戏是否结束
-    public native boolean isGameOver();
+    public boolean isGameOver() {
+        return nativeIsGameOver(session);
+    }
+    
+    // 获取AI建议的移动（同步，深度较大时会阻塞调用线程）
+    public int getAIMove(int depth) {
+        return nativeGetAIMove(session, depth);
+    }
+    
+    // 在后台线程中为当前棋盘开始AI搜索，立即返回；失败时返回false
+    public boolean startAISearch(int depth) {
+        return nativeStartAISearch(session, depth);
+    }
+    
+    // 查询后台搜索，不阻塞：返回方向、AI_SEARCH_RUNNING或AI_SEARCH_NONE，结果只返回一次
+    public int pollAISearch() {
+        return nativePollAISearch(session);
+    }
+    
+    // 取消后台搜索
+    public void cancelAISearch() {
+        nativeCancelAISearch(session);
+    }
+    
+    // 最近一次AI搜索的统计，下标见STAT_*常量；还没有搜索过时全部为0
+    public long[] getLastSearchStats() {
+        return nativeGetLastSearchStats(session);
+    }
     
-    // 获取AI建议的移动
-    public native int getAIMove(int depth);
+    // 原生会话接口（game2048_jni.c），句柄无效时返回默认值
+    private static native long nativeCreate(long seed, int tableSize);
+    private static native void nativeDestroy(long session);
+    private static native void nativeReset(long session);
+    private static native int[] nativeGetBoard(long session);
+    private static native long nativeGetPackedBoard(long session);
+    private static native boolean nativeMove(long session, int direction);
+    private static native int nativeGetScore(long session);
+    private static native int nativeGetBestScore(long session);
+    private static native boolean nativeIsGameOver(long session);
+    private static native int nativeGetAIMove(long session, int depth);
+    private static native boolean nativeStartAISearch(long session, int depth);
+    private static native int nativePollAISearch(long session);
+    private static native void nativeCancelAISearch(long session);
+    private static native long[] nativeGetLastSearchStats(long session);
     
     // 辅助方法：将一维数组转为二维
     public int[][] getBoardGrid() {
-        int[] flat = getBoard();
+        long board = getPackedBoard();
         int[][] grid = new int[BOARD_SIZE][BOARD_SIZE];
         
         for (int i = 0; i < BOARD_SIZE; i++) {
             for (int j = 0; j < BOARD_SIZE; j++) {
-                grid[i][j] = flat[i * BOARD_SIZE + j];
+                grid[i][j] = getTileValue(board, i, j);
             }
         }
         
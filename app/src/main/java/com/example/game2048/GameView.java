@@ -29,8 +29,45 @@ public class GameView extends View {
     private Paint cellPaint;
     private Paint textPaint;
     
-    // 游戏网格
-    private int[][] grid;
+    // 打包的64位棋盘，绘制时按格解码（见Game2048.getTileRank）
+    private long board;
+    
+    // 绘制时复用的砖块矩形，避免每帧分配
+    private final RectF tileRect = new RectF();
+    private final Paint.FontMetrics fontMetrics = new Paint.FontMetrics();
+    
+    // 各等级砖块的数字文本，下标为等级
+    private static final String[] TILE_TEXT = new String[16];
+    static {
+        for (int rank = 1; rank < TILE_TEXT.length; rank++) {
+            TILE_TEXT[rank] = String.valueOf(1 << rank);
+        }
+    }
+    
+    // AI搜索深度
+    private static final int AI_DEPTH = 3;
+    
+    // 轮询后台AI搜索的间隔（毫秒），约一帧
+    private static final int AI_POLL_INTERVAL_MS = 16;
+    
+    // 是否有AI搜索在后台进行
+    private boolean aiSearching = false;
+    
+    // 轮询AI搜索结果，拿到结果后执行移动
+    private final Runnable aiPoller = new Runnable() {
+        @Override
+        public void run() {
+            int direction = game.pollAISearch();
+            if (direction == Game2048.AI_SEARCH_RUNNING) {
+                postDelayed(this, AI_POLL_INTERVAL_MS);
+                return;
+            }
+            aiSearching = false;
+            if (direction >= 0 && game.move(direction)) {
+                updateGrid();
+            }
+        }
+    };
     
     // 网格单元大小和间距
     private float cellSize;
@@ -124,7 +161,8 @@ public class GameView extends View {
         // 绘制每个砖块
         for (int i = 0; i < 4; i++) {
             for (int j = 0; j < 4; j++) {
-                int value = grid[i][j];
+                int rank = Game2048.getTileRank(board, i, j);
+                int value = rank > 0 ? 1 << rank : 0;
                 
                 // 计算位置
                 float left = startX + j * (cellSize + cellMargin);
@@ -132,19 +170,13 @@ public class GameView extends View {
                 float right = left + cellSize;
                 float bottom = top + cellSize;
                 
-                // 确定颜色
-                int colorIndex = 0;
-                if (value > 0) {
-                    colorIndex = (int)(Math.log(value) / Math.log(2));
-                    if (colorIndex >= TILE_COLORS.length) {
-                        colorIndex = TILE_COLORS.length - 1;
-                    }
-                }
+                // 确定颜色，颜色表下标即砖块等级
+                int colorIndex = Math.min(rank, TILE_COLORS.length - 1);
                 
                 // 绘制砖块背景
                 cellPaint.setColor(TILE_COLORS[colorIndex]);
-                RectF rect = new RectF(left, top, right, bottom);
-                canvas.drawRoundRect(rect, cellSize / 10, cellSize / 10, cellPaint);
+                tileRect.set(left, top, right, bottom);
+                canvas.drawRoundRect(tileRect, cellSize / 10, cellSize / 10, cellPaint);
                 
                 // 如果不是空白，绘制数字
                 if (value > 0) {
@@ -157,12 +189,12 @@ public class GameView extends View {
                     textPaint.setTypeface(Typeface.DEFAULT_BOLD);
                     
                     // 计算文本位置
-                    Paint.FontMetrics fm = textPaint.getFontMetrics();
-                    float textHeight = fm.bottom - fm.top;
-                    float textBaseY = (top + bottom - textHeight) / 2 - fm.top;
+                    textPaint.getFontMetrics(fontMetrics);
+                    float textHeight = fontMetrics.bottom - fontMetrics.top;
+                    float textBaseY = (top + bottom - textHeight) / 2 - fontMetrics.top;
                     
                     // 绘制数字
-                    canvas.drawText(String.valueOf(value), (left + right) / 2, textBaseY, textPaint);
+                    canvas.drawText(TILE_TEXT[rank], (left + right) / 2, textBaseY, textPaint);
                 }
             }
         }
@@ -175,7 +207,7 @@ public class GameView extends View {
     
     // 更新网格数据
     private void updateGrid() {
-        grid = game.getBoardGrid();
+        board = game.getPackedBoard();
         
         // 通知分数变化
         if (gameListener != null) {
@@ -197,19 +229,51 @@ public class GameView extends View {
     
     // 重新开始游戏
     public void restart() {
+        cancelAI();
         game.initGame();
         updateGrid();
     }
     
-    // 使用AI移动
+    // 使用AI移动：在后台搜索，界面线程只轮询结果，搜索期间重复点击被忽略
     public void moveAI() {
-        int direction = game.getAIMove(3); // 深度为3
-        if (direction >= 0) {
-            game.move(direction);
+        if (aiSearching) {
+            return;
+        }
+        if (game.startAISearch(AI_DEPTH)) {
+            aiSearching = true;
+            postDelayed(aiPoller, AI_POLL_INTERVAL_MS);
+        }
+    }
+    
+    // 取消正在进行的AI搜索
+    private void cancelAI() {
+        if (aiSearching) {
+            removeCallbacks(aiPoller);
+            game.cancelAISearch();
+            aiSearching = false;
+        }
+    }
+    
+    @Override
+    protected void onAttachedToWindow() {
+        super.onAttachedToWindow();
+        // 移出窗口时已释放会话，重新加入时开始新的一局
+        if (game == null) {
+            game = new Game2048();
+            game.initGame();
             updateGrid();
         }
     }
     
+    @Override
+    protected void onDetachedFromWindow() {
+        cancelAI();
+        // 释放原生会话及其后台搜索线程和转置表，否则每次重建界面都会泄漏一份
+        game.release();
+        game = null;
+        super.onDetachedFromWindow();
+    }
+    
     // 手势监听类
     private class GestureListener extends GestureDetector.SimpleOnGestureListener {
         
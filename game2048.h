@@ -4,6 +4,10 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "game2048_tt.h"
+#include "game2048_heuristic.h"
+#include "game2048_rng.h"
 
 // 游戏常量
 #define BOARD_SIZE 4
@@ -36,7 +40,7 @@
 #define TILE_32_PROB 0.05
 
 // 转置表大小定义
-#define TRANSTABLE_SIZE 10485760  // 增加转置表大小，约为10M条目
+#define TRANSTABLE_SIZE (1 << 22)  // 转置表期望槽位数，实际为2^20个64字节桶（64MB，约3M槽位）
 
 // 游戏状态结构体
 typedef struct {
@@ -46,22 +50,83 @@ typedef struct {
     bool game_over;             // 游戏是否结束
 } GameState;
 
+// 搜索的截止时间和取消标志（不透明类型）
+typedef struct SearchDeadline SearchDeadline;
+
+// 机会节点的空位展开方式
+typedef enum {
+    SAMPLE_EXACT,               // 枚举全部空位，棋盘对称时合并等价的空位
+    SAMPLE_STOCHASTIC,          // 空位多于上限时无放回均匀抽样，抽样由棋盘决定，结果可复现
+    SAMPLE_LEGACY               // 原有的步长采样：空位为8个及以上时实际不展开任何空位，仅供对比
+} SampleMode;
+
+#define DEFAULT_MAX_SAMPLES 8   // 抽样模式下每个机会节点最多展开的空位数
+
+#define SEARCH_STATS_DEPTHS 16  // 按深度分层统计的层数，覆盖全部可用的搜索深度
+
+// 一次搜索的统计，计数均为64位。第d层指根之下已落下d个新砖块的节点：
+// 第d层的机会节点在第d+1次移动之后，其子节点是第d层的max节点
+typedef struct {
+    uint64_t chance_nodes[SEARCH_STATS_DEPTHS];    // 各层访问的机会节点数（含被截断和命中转置表的）
+    uint64_t move_nodes[SEARCH_STATS_DEPTHS];      // 各层展开的max节点数
+    uint64_t moves_evaled;      // 执行的移动数（含不改变棋盘的）
+    uint64_t heuristic_evals;   // 叶子的启发式评估次数
+    uint64_t cprob_prunes;      // 累计概率低于阈值而截断的机会节点
+    uint64_t depth_cutoffs;     // 到达深度限制的节点
+    uint64_t tt_probes;         // 转置表查找次数
+    uint64_t tt_hits;           // 命中且深度足够可直接使用的次数
+    uint64_t tt_inserts;        // 写入空槽
+    uint64_t tt_updates;        // 原地更新同一棋盘
+    uint64_t tt_evictions;      // 覆盖旧代条目
+    uint64_t tt_collisions;     // 桶满时淘汰当前代的其他棋盘
+    int maxdepth;               // 到达的最大深度
+    double elapsed_ms;          // 搜索用时
+} SearchStats;
+
 // 评估状态结构体
 typedef struct {
     void* trans_table;          // 转置表（C版本使用哈希表）
-    int maxdepth;               // 最大搜索深度
     int curdepth;               // 当前搜索深度
-    int cachehits;              // 缓存命中次数
-    int moves_evaled;           // 评估的移动数
+    SearchStats stats;          // 搜索统计（elapsed_ms由搜索入口填写）
     int depth_limit;            // 深度限制
+    void* pool;                 // 并行搜索线程池，NULL表示串行
+    int parallel_depth;         // 深度小于该值的机会节点将子节点作为任务并行求值
+    SearchDeadline* deadline;   // 截止时间和取消标志，NULL表示不可中止
+    int poll_countdown;         // 距下一次检查时钟和取消标志还需访问的机会节点数
+    const void* heur_table;     // 本次搜索使用的启发式表（格式见game2048_tables.h）
+    int sample_mode;            // 机会节点的展开方式（SampleMode）
+    int max_samples;            // 抽样模式下最多展开的空位数
+    bool tt_symmetry;           // 转置表按对称规范形式存取
 } EvalState;
 
+// 搜索上下文（不透明类型），持有跨多步复用的转置表
+typedef struct SearchContext SearchContext;
+
+// 一次搜索的结果和统计，通过search_context_set_report_callback获取
+typedef struct {
+    uint64_t board;             // 搜索的棋盘
+    int depth_limit;            // 实际使用的深度限制
+    int budget_ms;              // 限时搜索的预算，固定深度搜索为0
+    int completed_depth;        // 完整完成的深度（限时搜索为最后完成的一轮）
+    double move_scores[4];      // 按方向编号（UP/DOWN/LEFT/RIGHT）存放的得分
+    bool move_legal[4];         // 该方向能否移动
+    int best_move;              // 选择的方向，-1表示无法移动
+    double best_score;
+    SearchStats stats;          // 搜索统计，限时搜索为各轮（含中止的一轮）之和
+} SearchReport;
+
+typedef void (*SearchReportFunc)(const SearchReport* report, void* user);
+
 // 核心游戏函数声明
 void init_tables(void);
+int verify_tables(void);
 uint64_t execute_move(int move, uint64_t board);
+void execute_moves_batch(const uint64_t* boards, int count, uint64_t* out);
+bool execute_moves_use_simd(bool enable);
 int count_empty(uint64_t board);
 uint64_t transpose(uint64_t board);
 uint64_t add_random_tile(uint64_t board);
+uint64_t add_random_tile_r(uint64_t board, Rng* rng);
 int get_max_rank(uint64_t board);
 
 // 得分函数
@@ -69,6 +134,27 @@ double score_board(uint64_t board);
 double score_heur_board(uint64_t board);
 
 // AI算法函数
+SearchContext* search_context_create(size_t table_size);
+void search_context_destroy(SearchContext* ctx);
+// 搜索上下文创建后为串行搜索，多线程只在调用本函数后启用。
+// 注意：多线程搜索不保证选出与串行搜索相同的方向。各线程共享转置表，表项由先完成的子树写入，
+// 结果取决于线程调度：得分与串行搜索有细微差别（语料上深度5相对差最大约0.5%），得分接近的方向之间
+// 可能选得不同（80个语料棋盘中有1~3个），同一棋盘多次搜索的结果也不保证相同。
+// 需要与串行一致或逐步复现的场合（game2048_bench check、批量对局、界面和会话）不启用多线程
+bool search_context_set_threads(SearchContext* ctx, int num_threads);
+void search_context_set_parallel_depth(SearchContext* ctx, int depth);
+bool search_context_set_parallel_tt_mode(SearchContext* ctx, TTMode mode);
+void search_context_set_report_callback(SearchContext* ctx, SearchReportFunc func, void* user);
+void search_context_set_heuristic(SearchContext* ctx, const HeuristicTable* table);
+void search_context_set_sampling(SearchContext* ctx, SampleMode mode, int max_samples);
+void search_context_set_tt_symmetry(SearchContext* ctx, bool enable);
+void search_context_set_cancel(SearchContext* ctx, bool cancel);
+TransTable* search_context_table(SearchContext* ctx);
+void search_context_last_stats(const SearchContext* ctx, SearchStats* out);
+void search_stats_merge(SearchStats* total, const SearchStats* add);
+void search_stats_print(const SearchStats* stats);
+int find_best_move_ctx(SearchContext* ctx, GameState* state, int depth_limit);
+int find_best_move_timed(SearchContext* ctx, GameState* state, int budget_ms);
 int find_best_move(GameState* state, int depth_limit);
 
 // 辅助函数
@@ -78,6 +164,7 @@ bool is_game_over(GameState* state);
 
 // 游戏操作函数
 void init_game(GameState* state);
+void init_game_r(GameState* state, Rng* rng);
 bool move_up(GameState* state);
 bool move_down(GameState* state);
 bool move_left(GameState* state);
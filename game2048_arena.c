@@ -0,0 +1,123 @@
+// game2048_arena.c - 搜索期间的线程私有线性分配器
+//
+// 块组成单链表，current之前的块已用满，之后的块是归还后留待复用的空块。
+// 分配时当前块放不下就依次尝试后面的空块，都不够大才申请新块并插在current之后。
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "game2048_arena.h"
+
+#define ARENA_CHUNK_SIZE (64 << 10)     // 默认块大小，够放一个机会节点的全部并行任务
+
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t size;                // data的字节数
+    size_t used;
+    unsigned char data[];
+} ArenaChunk;
+
+struct Arena {
+    ArenaChunk* head;
+    ArenaChunk* current;        // 正在分配的块，NULL表示还没有块
+    size_t reserved;
+};
+
+static pthread_key_t arena_key;
+static pthread_once_t arena_key_once = PTHREAD_ONCE_INIT;
+
+static void arena_destroy(void* arg) {
+    Arena* arena = (Arena*)arg;
+    ArenaChunk* chunk = arena->head;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+}
+
+static void create_arena_key(void) {
+    pthread_key_create(&arena_key, arena_destroy);
+}
+
+Arena* arena_thread_local(void) {
+    pthread_once(&arena_key_once, create_arena_key);
+
+    Arena* arena = (Arena*)pthread_getspecific(arena_key);
+    if (!arena) {
+        arena = (Arena*)calloc(1, sizeof(Arena));
+        if (!arena) return NULL;
+        if (pthread_setspecific(arena_key, arena) != 0) {
+            free(arena);
+            return NULL;
+        }
+    }
+    return arena;
+}
+
+// 在块中按align对齐后能否放下size字节，能则返回偏移
+static bool chunk_fit(const ArenaChunk* chunk, size_t size, size_t align, size_t* offset) {
+    uintptr_t base = (uintptr_t)chunk->data;
+    size_t start = (size_t)(((base + chunk->used + align - 1) & ~(uintptr_t)(align - 1)) - base);
+    if (start > chunk->size || chunk->size - start < size) return false;
+    *offset = start;
+    return true;
+}
+
+void* arena_alloc(Arena* arena, size_t size, size_t align) {
+    size_t offset = 0;
+
+    // 当前块和之后的空块
+    ArenaChunk* chunk = arena->current ? arena->current : arena->head;
+    while (chunk) {
+        if (chunk != arena->current) chunk->used = 0;
+        if (chunk_fit(chunk, size, align, &offset)) {
+            arena->current = chunk;
+            chunk->used = offset + size;
+            return chunk->data + offset;
+        }
+        chunk = chunk->next;
+    }
+
+    // 申请新块，为对齐留出余量
+    size_t chunk_size = size + align;
+    if (chunk_size < ARENA_CHUNK_SIZE) chunk_size = ARENA_CHUNK_SIZE;
+    chunk = (ArenaChunk*)malloc(sizeof(ArenaChunk) + chunk_size);
+    if (!chunk) return NULL;
+    chunk->size = chunk_size;
+    chunk->used = 0;
+    if (arena->current) {
+        chunk->next = arena->current->next;
+        arena->current->next = chunk;
+    } else {
+        // 还没有分配过（或已全部归还且已有的块都太小），插在链表头
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+    arena->reserved += chunk_size;
+
+    chunk_fit(chunk, size, align, &offset);
+    arena->current = chunk;
+    chunk->used = offset + size;
+    return chunk->data + offset;
+}
+
+ArenaMark arena_mark(const Arena* arena) {
+    ArenaMark mark = { arena->current, arena->current ? arena->current->used : 0 };
+    return mark;
+}
+
+void arena_release(Arena* arena, ArenaMark mark) {
+    ArenaChunk* chunk = (ArenaChunk*)mark.chunk;
+    arena->current = chunk;
+    if (chunk) chunk->used = mark.used;
+}
+
+void arena_reset(Arena* arena) {
+    arena->current = NULL;
+}
+
+size_t arena_reserved(const Arena* arena) {
+    return arena->reserved;
+}
@@ -0,0 +1,35 @@
+// game2048_arena.h - 搜索期间的线程私有线性分配器
+//
+// 每个线程一个分配器，按块向系统申请内存，分配只移动指针。搜索中按嵌套顺序
+// 用arena_mark/arena_release归还（线程池嵌套等待时执行的任务总是先于外层完成，
+// 同一线程上的分配天然满足后进先出）；一次搜索结束后arena_reset整体归零。
+// 块在线程退出前一直保留，稳定运行时搜索不再调用malloc/free。
+#ifndef GAME2048_ARENA_H
+#define GAME2048_ARENA_H
+
+#include <stddef.h>
+
+typedef struct Arena Arena;
+
+// 分配位置，用于归还此后的全部分配
+typedef struct {
+    void* chunk;
+    size_t used;
+} ArenaMark;
+
+// 当前线程的分配器，首次调用时创建，线程退出时自动释放；内存不足时返回NULL
+Arena* arena_thread_local(void);
+
+// 分配size字节，按align（2的幂）对齐；内存不足时返回NULL
+void* arena_alloc(Arena* arena, size_t size, size_t align);
+
+ArenaMark arena_mark(const Arena* arena);
+void arena_release(Arena* arena, ArenaMark mark);
+
+// 归还全部分配，O(1)，块保留给之后的分配
+void arena_reset(Arena* arena);
+
+// 已向系统申请的字节数
+size_t arena_reserved(const Arena* arena);
+
+#endif // GAME2048_ARENA_H
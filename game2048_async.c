@@ -0,0 +1,211 @@
+// game2048_async.c - 在后台线程中执行的可取消搜索
+//
+// 一个后台线程持有搜索上下文，从单槽位的待办中领取搜索。提交新搜索或取消时
+// 置位上下文的取消标志，正在进行的搜索在下一次检查时钟时中止（通常在1ms内），
+// 后台线程随即领取新的搜索。所有状态由lock保护，搜索和回调在锁外执行。
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "game2048_async.h"
+#include "game2048_log.h"
+
+#define ASYNC_STACK_SIZE (4 << 20)      // 与线程池工作线程相同，搜索递归较深
+
+typedef struct {
+    uint64_t board;
+    int depth_limit;
+    int budget_ms;
+    AsyncSearchCallback callback;
+    void* user;
+} AsyncJob;
+
+struct AsyncSearch {
+    SearchContext* ctx;
+    pthread_t thread;
+
+    pthread_mutex_t lock;
+    pthread_cond_t job_cond;    // 有新的待办或要求退出
+    pthread_cond_t idle_cond;   // 一次搜索（含回调）结束，或待办被丢弃、取代
+
+    AsyncJob pending;
+    bool has_pending;
+    bool running;               // 后台线程正在搜索或回调
+    bool cancel_requested;      // 当前搜索已被取消（与上下文的取消标志同时置位）
+    bool shutdown;
+
+    AsyncSearchStatus status;   // 对外报告的状态
+    AsyncSearchResult result;   // 最近一次结束的搜索
+};
+
+// 要求正在进行的搜索中止，调用时持有lock
+static void cancel_running(AsyncSearch* as) {
+    if (as->running && !as->cancel_requested) {
+        as->cancel_requested = true;
+        search_context_set_cancel(as->ctx, true);
+    }
+}
+
+static void* async_worker(void* arg) {
+    AsyncSearch* as = (AsyncSearch*)arg;
+
+    pthread_mutex_lock(&as->lock);
+    for (;;) {
+        while (!as->has_pending && !as->shutdown) {
+            pthread_cond_wait(&as->job_cond, &as->lock);
+        }
+        if (as->shutdown) break;
+
+        AsyncJob job = as->pending;
+        as->has_pending = false;
+        as->running = true;
+        as->cancel_requested = false;
+        search_context_set_cancel(as->ctx, false);
+        pthread_mutex_unlock(&as->lock);
+
+        GameState state;
+        memset(&state, 0, sizeof(state));
+        state.board = job.board;
+        int move = job.budget_ms > 0 ? find_best_move_timed(as->ctx, &state, job.budget_ms)
+                                     : find_best_move_ctx(as->ctx, &state, job.depth_limit);
+
+        AsyncSearchResult result;
+        result.board = job.board;
+        search_context_last_stats(as->ctx, &result.stats);
+
+        pthread_mutex_lock(&as->lock);
+        // 搜索刚好完成时才到达的取消同样按取消处理，调用方不会收到过期的结果
+        bool cancelled = as->cancel_requested;
+        result.move = cancelled ? -1 : move;
+        result.status = cancelled ? ASYNC_SEARCH_CANCELLED : ASYNC_SEARCH_DONE;
+        as->result = result;
+        // 已有新的待办时保持RUNNING，调用方只关心最新提交的结果
+        if (!as->has_pending) as->status = result.status;
+        pthread_mutex_unlock(&as->lock);
+
+        if (job.callback) job.callback(&result, job.user);
+
+        pthread_mutex_lock(&as->lock);
+        as->running = false;
+        pthread_cond_broadcast(&as->idle_cond);
+    }
+    pthread_mutex_unlock(&as->lock);
+    return NULL;
+}
+
+AsyncSearch* async_search_create(size_t table_size) {
+    AsyncSearch* as = (AsyncSearch*)calloc(1, sizeof(AsyncSearch));
+    if (!as) return NULL;
+
+    as->ctx = search_context_create(table_size);
+    if (!as->ctx) {
+        free(as);
+        return NULL;
+    }
+    pthread_mutex_init(&as->lock, NULL);
+    pthread_cond_init(&as->job_cond, NULL);
+    pthread_cond_init(&as->idle_cond, NULL);
+    as->status = ASYNC_SEARCH_IDLE;
+    as->result.move = -1;
+    as->result.status = ASYNC_SEARCH_IDLE;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, ASYNC_STACK_SIZE);
+    int err = pthread_create(&as->thread, &attr, async_worker, as);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        LOG_ERROR("错误：无法创建后台搜索线程\n");
+        pthread_cond_destroy(&as->idle_cond);
+        pthread_cond_destroy(&as->job_cond);
+        pthread_mutex_destroy(&as->lock);
+        search_context_destroy(as->ctx);
+        free(as);
+        return NULL;
+    }
+    return as;
+}
+
+void async_search_destroy(AsyncSearch* as) {
+    if (!as) return;
+
+    pthread_mutex_lock(&as->lock);
+    as->shutdown = true;
+    as->has_pending = false;
+    cancel_running(as);
+    pthread_cond_signal(&as->job_cond);
+    pthread_cond_broadcast(&as->idle_cond);
+    pthread_mutex_unlock(&as->lock);
+    pthread_join(as->thread, NULL);
+
+    pthread_cond_destroy(&as->idle_cond);
+    pthread_cond_destroy(&as->job_cond);
+    pthread_mutex_destroy(&as->lock);
+    search_context_destroy(as->ctx);
+    free(as);
+}
+
+SearchContext* async_search_context(AsyncSearch* as) {
+    return as->ctx;
+}
+
+bool async_search_start(AsyncSearch* as, uint64_t board, int depth_limit, int budget_ms,
+                        AsyncSearchCallback callback, void* user) {
+    pthread_mutex_lock(&as->lock);
+    if (as->shutdown) {
+        pthread_mutex_unlock(&as->lock);
+        return false;
+    }
+    cancel_running(as);
+    // 取代还没开始的待办：等待中的线程重新检查条件，之后等的是新的待办
+    if (as->has_pending) pthread_cond_broadcast(&as->idle_cond);
+    as->pending.board = board;
+    as->pending.depth_limit = depth_limit;
+    as->pending.budget_ms = budget_ms;
+    as->pending.callback = callback;
+    as->pending.user = user;
+    as->has_pending = true;
+    as->status = ASYNC_SEARCH_RUNNING;
+    pthread_cond_signal(&as->job_cond);
+    pthread_mutex_unlock(&as->lock);
+    return true;
+}
+
+AsyncSearchStatus async_search_poll(AsyncSearch* as, int* move, uint64_t* board) {
+    pthread_mutex_lock(&as->lock);
+    AsyncSearchStatus status = as->status;
+    if (status == ASYNC_SEARCH_DONE || status == ASYNC_SEARCH_CANCELLED) {
+        if (move) *move = as->result.move;
+        if (board) *board = as->result.board;
+        as->status = ASYNC_SEARCH_IDLE;
+    }
+    pthread_mutex_unlock(&as->lock);
+    return status;
+}
+
+void async_search_cancel(AsyncSearch* as) {
+    pthread_mutex_lock(&as->lock);
+    // 丢弃的待办不会再由后台线程运行，它结束时的广播不会到来，这里唤醒等待它的线程
+    if (as->has_pending) {
+        as->has_pending = false;
+        pthread_cond_broadcast(&as->idle_cond);
+    }
+    cancel_running(as);
+    // 只丢弃了待办时没有结果可报告；正在进行的搜索结束后状态变为CANCELLED
+    if (!as->running) as->status = ASYNC_SEARCH_IDLE;
+    pthread_mutex_unlock(&as->lock);
+}
+
+void async_search_wait(AsyncSearch* as) {
+    pthread_mutex_lock(&as->lock);
+    while (as->running || as->has_pending) {
+        pthread_cond_wait(&as->idle_cond, &as->lock);
+    }
+    pthread_mutex_unlock(&as->lock);
+}
+
+void async_search_last_stats(AsyncSearch* as, SearchStats* out) {
+    pthread_mutex_lock(&as->lock);
+    *out = as->result.stats;
+    pthread_mutex_unlock(&as->lock);
+}
@@ -0,0 +1,58 @@
+// game2048_async.h - 在后台线程中执行的可取消搜索
+//
+// 界面线程调用async_search_start提交棋盘后立即返回，每帧用async_search_poll
+// 查询结果（或在完成回调中处理），搜索期间界面照常渲染。新的提交会取消正在
+// 进行的搜索，同一时刻只有一个搜索在运行。
+#ifndef GAME2048_ASYNC_H
+#define GAME2048_ASYNC_H
+
+#include <stdint.h>
+#include "game2048.h"
+
+typedef enum {
+    ASYNC_SEARCH_IDLE,          // 没有搜索，或结果已被取走
+    ASYNC_SEARCH_RUNNING,       // 搜索正在进行或等待开始
+    ASYNC_SEARCH_DONE,          // 搜索完成，结果可用
+    ASYNC_SEARCH_CANCELLED      // 搜索被取消或被新的提交取代
+} AsyncSearchStatus;
+
+typedef struct {
+    uint64_t board;             // 搜索的棋盘
+    int move;                   // 最佳方向，-1表示无法移动或已取消
+    AsyncSearchStatus status;   // ASYNC_SEARCH_DONE或ASYNC_SEARCH_CANCELLED
+    SearchStats stats;
+} AsyncSearchResult;
+
+// 完成回调，在后台线程中调用；每个开始执行的搜索恰好回调一次（含被取消的），
+// 还没开始就被新提交取代的搜索不回调。回调中不能调用async_search_wait/destroy
+typedef void (*AsyncSearchCallback)(const AsyncSearchResult* result, void* user);
+
+typedef struct AsyncSearch AsyncSearch;
+
+// 创建后台搜索，table_size为转置表期望槽位数
+AsyncSearch* async_search_create(size_t table_size);
+// 取消正在进行的搜索并等待后台线程退出
+void async_search_destroy(AsyncSearch* as);
+
+// 后台搜索使用的上下文，只能在空闲时（提交前或async_search_wait之后）修改设置
+SearchContext* async_search_context(AsyncSearch* as);
+
+// 提交搜索：budget_ms > 0时限时搜索，否则按depth_limit固定深度搜索。
+// 立即返回；正在进行或等待开始的搜索被取代。callback可以为NULL
+bool async_search_start(AsyncSearch* as, uint64_t board, int depth_limit, int budget_ms,
+                        AsyncSearchCallback callback, void* user);
+
+// 查询状态，不阻塞。返回DONE或CANCELLED时取走结果（之后返回IDLE），
+// move和board非NULL时填写结果的方向和搜索的棋盘
+AsyncSearchStatus async_search_poll(AsyncSearch* as, int* move, uint64_t* board);
+
+// 取消正在进行和等待开始的搜索，不阻塞；后台线程在下一次检查取消标志时中止
+void async_search_cancel(AsyncSearch* as);
+
+// 阻塞直到没有正在进行的搜索（包括其完成回调）
+void async_search_wait(AsyncSearch* as);
+
+// 最近一次完成或中止的搜索的统计
+void async_search_last_stats(AsyncSearch* as, SearchStats* out);
+
+#endif // GAME2048_ASYNC_H
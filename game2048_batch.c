@@ -0,0 +1,216 @@
+// game2048_batch.c - 无界面批量自我对局
+//
+// 每个线程持有独立的搜索上下文（串行搜索、独立转置表），从共享计数器领取
+// 局号，多局同时进行。每局使用由基础种子派生的独立随机数序列生成新砖块，
+// 且开局时清空转置表，因此固定深度搜索时同一种子总能复现同一局，
+// 与线程数和局的分配顺序无关。
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "game2048_batch.h"
+#include "game2048_pool.h"
+
+#define BATCH_DEFAULT_TABLE_SIZE (1 << 20)     // 每线程16MB，多核时总内存可控
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void batch_config_init(BatchConfig* config) {
+    config->num_games = 100;
+    config->num_threads = 0;
+    config->depth_limit = 5;
+    config->budget_ms = 0;
+    config->seed = 2048;
+    config->table_size = BATCH_DEFAULT_TABLE_SIZE;
+    config->max_moves = 0;
+    config->heuristic = NULL;
+    config->sample_mode = SAMPLE_EXACT;
+    config->max_samples = 0;
+}
+
+// 用splitmix64的终结函数把相邻的局号映射为互不相关的种子
+uint64_t batch_game_seed(uint64_t base_seed, int index) {
+    return splitmix64_mix(base_seed + 0x9E3779B97F4A7C15ULL * (uint64_t)(index + 1));
+}
+
+static bool apply_move(GameState* state, int move) {
+    switch (move) {
+        case UP: return move_up(state);
+        case DOWN: return move_down(state);
+        case LEFT: return move_left(state);
+        case RIGHT: return move_right(state);
+        default: return false;
+    }
+}
+
+static void add_stats(const SearchReport* report, void* user) {
+    search_stats_merge((SearchStats*)user, &report->stats);
+}
+
+void play_game(SearchContext* ctx, const BatchConfig* config, uint64_t seed, GameResult* result) {
+    GameState state = { 0, 0, 0, false };
+    Rng rng;
+    int moves = 0;
+    double start = now_seconds();
+    memset(&result->stats, 0, sizeof(result->stats));
+
+    search_context_set_heuristic(ctx, config->heuristic);
+    search_context_set_sampling(ctx, config->sample_mode, config->max_samples);
+    trans_table_clear(search_context_table(ctx));
+    search_context_set_report_callback(ctx, add_stats, &result->stats);
+
+    rng_seed(&rng, seed);
+    state.board = add_random_tile_r(state.board, &rng);
+    state.board = add_random_tile_r(state.board, &rng);
+
+    while (config->max_moves <= 0 || moves < config->max_moves) {
+        int move = config->budget_ms > 0
+            ? find_best_move_timed(ctx, &state, config->budget_ms)
+            : find_best_move_ctx(ctx, &state, config->depth_limit);
+        if (move < 0 || !apply_move(&state, move)) {
+            break;
+        }
+        state.board = add_random_tile_r(state.board, &rng);
+        moves++;
+    }
+    search_context_set_report_callback(ctx, NULL, NULL);
+    search_context_set_heuristic(ctx, NULL);
+
+    result->seed = seed;
+    result->final_board = state.board;
+    result->score = state.score;
+    result->max_rank = get_max_rank(state.board);
+    result->moves = moves;
+    result->nodes = (long long)result->stats.moves_evaled;
+    result->seconds = now_seconds() - start;
+}
+
+typedef struct {
+    const BatchConfig* config;
+    GameResult* results;
+    atomic_int next_game;
+    atomic_bool failed;
+} BatchShared;
+
+static void* batch_worker(void* arg) {
+    BatchShared* shared = (BatchShared*)arg;
+    const BatchConfig* config = shared->config;
+
+    SearchContext* ctx = search_context_create(config->table_size);
+    if (!ctx) {
+        atomic_store(&shared->failed, true);
+        return NULL;
+    }
+
+    for (;;) {
+        int index = atomic_fetch_add(&shared->next_game, 1);
+        if (index >= config->num_games) break;
+        play_game(ctx, config, batch_game_seed(config->seed, index), &shared->results[index]);
+    }
+
+    search_context_destroy(ctx);
+    return NULL;
+}
+
+static int compare_int(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static void summarize(const GameResult* results, int count, double wall_seconds, BatchSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    summary->games = count;
+    summary->wall_seconds = wall_seconds;
+    if (count <= 0) return;
+
+    int* scores = (int*)malloc(count * sizeof(int));
+    double score_sum = 0;
+    for (int i = 0; i < count; i++) {
+        summary->total_moves += results[i].moves;
+        summary->total_nodes += results[i].nodes;
+        search_stats_merge(&summary->stats, &results[i].stats);
+        summary->max_rank_count[results[i].max_rank & 0xf]++;
+        score_sum += results[i].score;
+        if (scores) scores[i] = results[i].score;
+    }
+    summary->score_mean = score_sum / count;
+    summary->games_per_sec = wall_seconds > 0 ? count / wall_seconds : 0;
+    summary->moves_per_sec = wall_seconds > 0 ? summary->total_moves / wall_seconds : 0;
+    summary->nodes_per_sec = wall_seconds > 0 ? summary->total_nodes / wall_seconds : 0;
+
+    if (scores) {
+        qsort(scores, count, sizeof(int), compare_int);
+        summary->score_min = scores[0];
+        summary->score_median = scores[count / 2];
+        summary->score_max = scores[count - 1];
+        free(scores);
+    }
+}
+
+bool run_batch(const BatchConfig* config, GameResult* results, BatchSummary* summary) {
+    int num_threads = config->num_threads > 0 ? config->num_threads : thread_pool_cpu_count();
+    if (num_threads > config->num_games) num_threads = config->num_games;
+    if (num_threads < 1) num_threads = 1;
+
+    pthread_t* threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    if (!threads) return false;
+
+    BatchShared shared;
+    shared.config = config;
+    shared.results = results;
+    atomic_init(&shared.next_game, 0);
+    atomic_init(&shared.failed, false);
+
+    init_tables();
+
+    double start = now_seconds();
+    int started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        if (pthread_create(&threads[i], NULL, batch_worker, &shared) != 0) break;
+        started++;
+    }
+    // 线程全部创建失败时在当前线程下完所有对局
+    if (started == 0) {
+        batch_worker(&shared);
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double wall_seconds = now_seconds() - start;
+    free(threads);
+
+    if (atomic_load(&shared.failed) && atomic_load(&shared.next_game) < config->num_games) {
+        return false;
+    }
+
+    if (summary) {
+        summarize(results, config->num_games, wall_seconds, summary);
+    }
+    return true;
+}
+
+void batch_print_summary(const BatchSummary* summary) {
+    printf("对局数: %d，用时 %.2f 秒\n", summary->games, summary->wall_seconds);
+    printf("速度: %.2f 局/秒，%.1f 步/秒（共%lld步），搜索 %.0f 节点/秒\n",
+           summary->games_per_sec, summary->moves_per_sec, summary->total_moves, summary->nodes_per_sec);
+    printf("得分: 平均 %.0f，最低 %d，中位数 %d，最高 %d\n",
+           summary->score_mean, summary->score_min, summary->score_median, summary->score_max);
+
+    printf("最大砖块分布:\n");
+    int at_least = 0;
+    for (int rank = 15; rank >= 1; rank--) {
+        at_least += summary->max_rank_count[rank];
+        if (summary->max_rank_count[rank] == 0) continue;
+        printf("  %6d: %5d局 (%5.1f%%)  达到该值及以上: %5.1f%%\n",
+               1 << rank, summary->max_rank_count[rank],
+               100.0 * summary->max_rank_count[rank] / summary->games,
+               100.0 * at_least / summary->games);
+    }
+}
@@ -0,0 +1,67 @@
+// game2048_batch.h - 无界面批量自我对局
+#ifndef GAME2048_BATCH_H
+#define GAME2048_BATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "game2048.h"
+
+// 批量对局配置
+typedef struct {
+    int num_games;              // 对局数
+    int num_threads;            // 同时进行的对局数，<=0使用全部CPU核心
+    int depth_limit;            // 固定深度搜索的深度上限
+    int budget_ms;              // >0时改用限时搜索，每步预算毫秒数
+    uint64_t seed;              // 基础种子，第i局的种子由它和i派生
+    size_t table_size;          // 每个线程的转置表期望槽位数
+    int max_moves;              // 单局步数上限，<=0不限
+    const HeuristicTable* heuristic;    // 启发式表，NULL使用默认表
+    SampleMode sample_mode;     // 机会节点的展开方式
+    int max_samples;            // 抽样模式下最多展开的空位数，<=0使用默认值
+} BatchConfig;
+
+// 单局结果
+typedef struct {
+    uint64_t seed;              // 本局种子，可单独复现
+    uint64_t final_board;       // 终局棋盘
+    int score;                  // 得分
+    int max_rank;               // 最大砖块等级
+    int moves;                  // 步数
+    long long nodes;            // 搜索评估的移动总数
+    double seconds;             // 用时
+    SearchStats stats;          // 本局各步搜索统计之和
+} GameResult;
+
+// 汇总统计
+typedef struct {
+    int games;
+    long long total_moves;
+    long long total_nodes;
+    double wall_seconds;
+    double games_per_sec;
+    double moves_per_sec;
+    double nodes_per_sec;
+    double score_mean;
+    int score_min;
+    int score_median;
+    int score_max;
+    int max_rank_count[16];     // 最大砖块等级为i的局数
+    SearchStats stats;          // 全部对局的搜索统计之和（用时为各线程搜索用时之和）
+} BatchSummary;
+
+void batch_config_init(BatchConfig* config);
+
+// 第index局的种子
+uint64_t batch_game_seed(uint64_t base_seed, int index);
+
+// 用给定上下文和种子下完一局；上下文的转置表在开局时清空，结果只取决于种子和配置。
+// 对局期间占用上下文的搜索统计回调、启发式表和展开方式设置
+void play_game(SearchContext* ctx, const BatchConfig* config, uint64_t seed, GameResult* result);
+
+// 多线程下完config->num_games局，results按局号填充；summary可为NULL
+bool run_batch(const BatchConfig* config, GameResult* results, BatchSummary* summary);
+
+void batch_print_summary(const BatchSummary* summary);
+
+#endif // GAME2048_BATCH_H
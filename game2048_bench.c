@@ -0,0 +1,884 @@
+// game2048_bench.c - 性能基准测试
+//
+// 编译: 根目录CMake的game2048_bench目标
+// 用法: game2048_bench micro [轮数] [最大搜索深度]
+//       game2048_bench tt [最大线程数] [每线程操作数]
+//       game2048_bench hash [基础棋盘数]
+//       game2048_bench check [tables|heuristic|tt|session|corpus]
+//       game2048_bench sampling [搜索深度]
+//       game2048_bench symmetry [最大搜索深度]
+//   micro 微基准：在固定棋盘语料上测量各基本操作的ns/次和整步搜索的节点/秒，
+//         作为引擎改动前后的性能回归基线
+//   tt    并发转置表：对比条带互斥锁与无锁两种方式在不同线程数下的吞吐量
+//   hash  桶下标哈希：对比乘法移位与Zobrist的速度、桶占用和冲突情况
+//   check 正确性：查表（含构建期生成的表和按默认权重生成的启发式表）与运行时生成一致，
+//         批量走子与逐方向走子一致，深度3/5的最佳方向与语料记录一致；
+//         改用float/定点启发式表等近似格式后用它确认走法不变；
+//         可只执行其中一项（tables 查表与批量走子，heuristic 启发式表存储格式的误差，
+//         tt 转置表的替换策略，session 会话后台搜索的等待与打断，corpus 语料最佳方向），
+//         ctest按项注册
+//   sampling 机会节点展开方式：以精确展开为基准，比较各抽样方式的耗时、节点数、
+//         最佳方向一致率，以及所选方向按精确得分计算的损失
+//   symmetry 转置表对称合并：对比开关前后的命中率、节点数、耗时和最佳方向
+#ifdef __linux__
+#define _GNU_SOURCE                     // SCHED_IDLE（check session）
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <float.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "game2048.h"
+#include "game2048_tables.h"
+#include "game2048_tt.h"
+#include "game2048_pool.h"
+#include "game2048_session.h"
+#include "game2048_bench_corpus.h"
+
+#define BENCH_TT_SLOTS (1 << 22)        // 转置表槽位数
+#define BENCH_TT_KEYS (1 << 21)         // 参与测试的不同棋盘数
+
+// 单调时钟，单位秒
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t xorshift64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+typedef struct {
+    TransTable* table;
+    const uint64_t* keys;
+    long ops;
+    uint64_t seed;
+    long hits;
+} TTBenchThread;
+
+// 模拟搜索中机会节点的访问模式：先查表，未命中则写入
+static void* tt_bench_thread(void* arg) {
+    TTBenchThread* t = (TTBenchThread*)arg;
+    TransEntry entry;
+
+    for (long i = 0; i < t->ops; i++) {
+        uint64_t r = xorshift64(&t->seed);
+        uint64_t key = t->keys[r % BENCH_TT_KEYS];
+        if (find_in_table(t->table, key, &entry)) {
+            t->hits++;
+        } else {
+            insert_to_table(t->table, key, (int)(r >> 60), (double)(r >> 40));
+        }
+    }
+
+    return NULL;
+}
+
+// 返回每秒操作数
+static double run_tt_bench(TransTable* table, const uint64_t* keys, int num_threads, long ops, double* hit_rate) {
+    pthread_t threads[256];
+    TTBenchThread args[256];
+
+    trans_table_new_generation(table);
+
+    double start = now_seconds();
+    for (int i = 0; i < num_threads; i++) {
+        args[i].table = table;
+        args[i].keys = keys;
+        args[i].ops = ops;
+        args[i].seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+        args[i].hits = 0;
+        pthread_create(&threads[i], NULL, tt_bench_thread, &args[i]);
+    }
+
+    long hits = 0;
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+        hits += args[i].hits;
+    }
+    double elapsed = now_seconds() - start;
+
+    *hit_rate = (double)hits / ((double)ops * num_threads);
+    return (double)ops * num_threads / elapsed;
+}
+
+static int bench_tt(int max_threads, long ops) {
+    static const TTMode modes[] = { TT_MODE_STRIPED, TT_MODE_LOCKFREE };
+    static const char* mode_names[] = { "条带锁", "无锁" };
+
+    uint64_t* keys = (uint64_t*)malloc(BENCH_TT_KEYS * sizeof(uint64_t));
+    TransTable* table = create_trans_table(BENCH_TT_SLOTS);
+    if (!keys || !table) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+
+    uint64_t seed = 88172645463325252ULL;
+    for (int i = 0; i < BENCH_TT_KEYS; i++) {
+        do {
+            keys[i] = xorshift64(&seed);
+        } while (keys[i] == 0);
+    }
+
+    printf("并发转置表基准：%d个槽位，%d个不同棋盘，每线程%ld次查找/写入\n",
+           BENCH_TT_SLOTS, BENCH_TT_KEYS, ops);
+    printf("%-8s %6s %12s %8s %8s\n", "方式", "线程", "Mops/s", "加速比", "命中率");
+
+    for (int m = 0; m < 2; m++) {
+        if (!trans_table_set_mode(table, modes[m])) {
+            fprintf(stderr, "无法切换转置表模式\n");
+            return 1;
+        }
+
+        double base = 0;
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            double hit_rate;
+            double rate = run_tt_bench(table, keys, threads, ops, &hit_rate);
+            if (threads == 1) base = rate;
+            printf("%-8s %6d %12.2f %8.2f %7.1f%%\n",
+                   mode_names[m], threads, rate / 1e6, rate / base, hit_rate * 100);
+            if (threads < max_threads && threads * 2 > max_threads) {
+                threads = max_threads / 2;
+            }
+        }
+    }
+
+    free_trans_table(table);
+    free(keys);
+    return 0;
+}
+
+// 随机生成一个对局中期风格的棋盘：约一半格子为空，等级偏向低值
+static uint64_t random_midgame_board(uint64_t* seed) {
+    uint64_t board = 0;
+    for (int pos = 0; pos < 16; pos++) {
+        uint64_t r = xorshift64(seed);
+        if (r & 1) continue;
+        int rank = 1;
+        while (rank < 11 && ((r >> (rank + 1)) & 3) == 0) rank++;
+        board |= (uint64_t)rank << (4 * pos);
+    }
+    return board ? board : 1;
+}
+
+// 机会节点的子节点：在每个空格放置2或4，与父节点只差一个格子
+static size_t build_hash_keys(uint64_t* keys, size_t capacity, int num_bases) {
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    size_t n = 0;
+
+    for (int b = 0; b < num_bases && n < capacity; b++) {
+        uint64_t board = random_midgame_board(&seed);
+        keys[n++] = board;
+
+        for (int pos = 0; pos < 16 && n + 2 <= capacity; pos++) {
+            if ((board >> (4 * pos)) & 0xf) continue;
+            for (int rank = 1; rank <= 2; rank++) {
+                keys[n++] = board | ((uint64_t)rank << (4 * pos));
+            }
+        }
+    }
+
+    return n;
+}
+
+static int bench_hash(int num_bases) {
+    static const TTHash hashes[] = { TT_HASH_MULSHIFT, TT_HASH_ZOBRIST };
+    static const char* hash_names[] = { "乘法移位", "Zobrist" };
+
+    size_t capacity = (size_t)num_bases * 33;
+    uint64_t* keys = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+    TransTable* table = create_trans_table(BENCH_TT_SLOTS);
+    if (!keys || !table) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+
+    size_t num_keys = build_hash_keys(keys, capacity, num_bases);
+    printf("哈希基准：%d个基础棋盘及其机会子节点，共%zu个棋盘，%d个槽位\n",
+           num_bases, num_keys, BENCH_TT_SLOTS);
+
+    // 纯哈希速度，累加结果防止被优化掉
+    uint64_t sink = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < num_keys; i++) sink += hash_function(keys[i], 44);
+    double mulshift_ns = (now_seconds() - start) * 1e9 / num_keys;
+    start = now_seconds();
+    for (size_t i = 0; i < num_keys; i++) sink += zobrist_hash(keys[i]);
+    double zobrist_ns = (now_seconds() - start) * 1e9 / num_keys;
+    printf("每次哈希: 乘法移位 %.2f ns, Zobrist完整计算 %.2f ns (校验和 %llx)\n",
+           mulshift_ns, zobrist_ns, (unsigned long long)(sink & 0xffff));
+
+    for (int h = 0; h < 2; h++) {
+        TransEntry entry;
+        TransTableStats stats;
+
+        trans_table_set_hash(table, hashes[h]);
+        trans_table_enable_stats(table, false);
+        trans_table_enable_stats(table, true);
+
+        start = now_seconds();
+        for (size_t i = 0; i < num_keys; i++) {
+            if (!find_in_table(table, keys[i], &entry)) {
+                insert_to_table(table, keys[i], (int)(i & 7), (double)i);
+            }
+        }
+        double elapsed = now_seconds() - start;
+
+        printf("\n[%s] 查找/写入 %.1f ns/次\n", hash_names[h], elapsed * 1e9 / num_keys);
+        trans_table_get_stats(table, &stats);
+        trans_table_print_stats(&stats);
+    }
+
+    free_trans_table(table);
+    free(keys);
+    return 0;
+}
+
+static volatile uint64_t bench_sink;   // 累加结果，防止被测调用被优化掉
+
+static void report_ns(const char* name, double seconds, double ops) {
+    printf("%-24s %10.2f ns/次\n", name, seconds * 1e9 / ops);
+}
+
+// 对语料中每个棋盘求值expr rounds轮，expr中可使用board
+#define BENCH_BOARDS(name, expr) \
+    do { \
+        uint64_t sink = 0; \
+        double start = now_seconds(); \
+        for (int r = 0; r < rounds; r++) { \
+            for (int i = 0; i < BENCH_CORPUS_SIZE; i++) { \
+                uint64_t board = bench_corpus[i].board; \
+                sink += (uint64_t)(expr); \
+            } \
+        } \
+        report_ns(name, now_seconds() - start, (double)rounds * BENCH_CORPUS_SIZE); \
+        bench_sink += sink; \
+    } while (0)
+
+// 批量走子：每个棋盘一次生成四个方向，按棋盘计时
+static void bench_batch_moves(int rounds) {
+    uint64_t boards[BENCH_CORPUS_SIZE];
+    uint64_t out[4 * BENCH_CORPUS_SIZE];
+    uint64_t sink = 0;
+
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+        boards[i] = bench_corpus[i].board;
+    }
+
+    for (int simd = 0; simd < 2; simd++) {
+        if (execute_moves_use_simd(simd) != (bool)simd) {
+            printf("%-24s %10s\n", "execute_moves_batch(simd)", "不支持");
+            continue;
+        }
+        double start = now_seconds();
+        for (int r = 0; r < rounds; r++) {
+            execute_moves_batch(boards, BENCH_CORPUS_SIZE, out);
+            sink += out[r % (4 * BENCH_CORPUS_SIZE)];
+        }
+        report_ns(simd ? "execute_moves_batch(simd)" : "execute_moves_batch(标量)",
+                  now_seconds() - start, (double)rounds * BENCH_CORPUS_SIZE);
+    }
+    execute_moves_use_simd(true);
+    bench_sink += sink;
+}
+
+static void bench_board_ops(int rounds) {
+    static const char* names[4] = { "execute_move(UP)", "execute_move(DOWN)",
+                                    "execute_move(LEFT)", "execute_move(RIGHT)" };
+
+    for (int move = 0; move < 4; move++) {
+        BENCH_BOARDS(names[move], execute_move(move, board));
+    }
+    bench_batch_moves(rounds);
+    BENCH_BOARDS("transpose", transpose(board));
+    BENCH_BOARDS("count_empty", count_empty(board));
+    BENCH_BOARDS("get_max_rank", get_max_rank(board));
+    BENCH_BOARDS("score_heur_board", score_heur_board(board));
+
+    // 按配置重新生成一张启发式表
+    HeuristicConfig config;
+    heuristic_config_init(&config);
+    int table_rounds = rounds / 10000 > 0 ? rounds / 10000 : 1;
+    double start = now_seconds();
+    for (int r = 0; r < table_rounds; r++) {
+        heuristic_table_destroy(heuristic_table_create(&config));
+    }
+    printf("%-24s %10.3f ms/次\n", "heuristic_table_create", (now_seconds() - start) * 1e3 / table_rounds);
+}
+
+// 转置表：写入BENCH_TT_KEYS个棋盘，再分别查找已写入（命中）和未写入（未命中）的棋盘
+static int bench_table_ops(void) {
+    uint64_t* keys = (uint64_t*)malloc(2 * BENCH_TT_KEYS * sizeof(uint64_t));
+    TransTable* table = create_trans_table(BENCH_TT_SLOTS);
+    if (!keys || !table) {
+        fprintf(stderr, "内存不足\n");
+        free(keys);
+        free_trans_table(table);
+        return 1;
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 2 * BENCH_TT_KEYS; i++) {
+        keys[i] = random_midgame_board(&seed);
+    }
+
+    TransEntry entry;
+    long found = 0;
+
+    // 先清空一次使整表内存都已映射，避免把缺页时间计入写入
+    trans_table_clear(table);
+
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_TT_KEYS; i++) {
+        insert_to_table(table, keys[i], i & 7, (double)i);
+    }
+    report_ns("insert_to_table", now_seconds() - start, BENCH_TT_KEYS);
+
+    start = now_seconds();
+    for (int i = 0; i < BENCH_TT_KEYS; i++) {
+        found += find_in_table(table, keys[i], &entry);
+    }
+    report_ns("find_in_table(hit)", now_seconds() - start, BENCH_TT_KEYS);
+
+    start = now_seconds();
+    for (int i = BENCH_TT_KEYS; i < 2 * BENCH_TT_KEYS; i++) {
+        found += find_in_table(table, keys[i], &entry);
+    }
+    report_ns("find_in_table(miss)", now_seconds() - start, BENCH_TT_KEYS);
+    bench_sink += found;
+
+    free_trans_table(table);
+    free(keys);
+    return 0;
+}
+
+static void add_report_nodes(const SearchReport* report, void* user) {
+    *(long long*)user += report->stats.moves_evaled;
+}
+
+// 整步搜索：对语料中每个棋盘做一次固定深度搜索（串行，每步新一代转置表）
+static int bench_search(int max_depth) {
+    SearchContext* ctx = search_context_create(TRANSTABLE_SIZE);
+    if (!ctx) {
+        fprintf(stderr, "无法创建搜索上下文\n");
+        return 1;
+    }
+
+    long long nodes = 0;
+    search_context_set_report_callback(ctx, add_report_nodes, &nodes);
+
+    printf("%-8s %12s %14s\n", "深度", "ms/步", "节点/秒");
+    for (int depth = 1; depth <= max_depth; depth++) {
+        int mismatches = 0;
+        nodes = 0;
+
+        double start = now_seconds();
+        for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+            GameState state = { bench_corpus[i].board, 0, 0, false };
+            int move = find_best_move_ctx(ctx, &state, depth);
+            if (depth == 3 && move != bench_corpus[i].best_move_d3) {
+                mismatches++;
+            }
+        }
+        double elapsed = now_seconds() - start;
+
+        printf("%-8d %12.3f %14.0f\n", depth, elapsed * 1e3 / BENCH_CORPUS_SIZE, nodes / elapsed);
+        if (depth == 3 && mismatches > 0) {
+            printf("  注意：%d/%d个棋盘的最佳方向与语料记录不同\n", mismatches, BENCH_CORPUS_SIZE);
+        }
+    }
+
+    search_context_destroy(ctx);
+    return 0;
+}
+
+static int bench_micro(int rounds, int max_depth) {
+    init_tables();
+
+    printf("微基准：%d个语料棋盘，每项%d轮\n", BENCH_CORPUS_SIZE, rounds);
+    bench_board_ops(rounds);
+    if (bench_table_ops() != 0) return 1;
+    printf("\n");
+    return bench_search(max_depth);
+}
+
+// 语料上的正确性检查，全部一致返回0
+// 查表、按默认权重生成的启发式表和批量走子与运行时逐项计算的结果一致，返回不一致的项数
+static int check_tables(void) {
+    int failures = 0;
+
+    int table_mismatches = verify_tables();
+    printf("查表与运行时生成结果：%s\n", table_mismatches == 0 ? "一致" : "不一致");
+    failures += table_mismatches;
+
+    // 按默认权重在运行时生成的启发式表应与内置表完全相同
+    HeuristicConfig config;
+    heuristic_config_init(&config);
+    HeuristicTable* heuristic = heuristic_table_create(&config);
+    if (heuristic) {
+        int heur_mismatches = 0;
+        for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+            for (int move = 0; move < 4; move++) {
+                uint64_t board = execute_move(move, bench_corpus[i].board);
+                if (heuristic_table_score(heuristic, board) != score_heur_board(board)) heur_mismatches++;
+            }
+        }
+        printf("默认权重生成的启发式表：%s\n", heur_mismatches == 0 ? "与内置表一致" : "与内置表不一致");
+        failures += heur_mismatches;
+        heuristic_table_destroy(heuristic);
+    }
+
+    uint64_t boards[BENCH_CORPUS_SIZE];
+    uint64_t out[4 * BENCH_CORPUS_SIZE];
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+        boards[i] = bench_corpus[i].board;
+    }
+    for (int simd = 0; simd < 2; simd++) {
+        if (execute_moves_use_simd(simd) != (bool)simd) continue;
+        int mismatches = 0;
+        execute_moves_batch(boards, BENCH_CORPUS_SIZE, out);
+        for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+            for (int move = 0; move < 4; move++) {
+                if (out[4 * i + move] != execute_move(move, boards[i])) mismatches++;
+            }
+        }
+        printf("execute_moves_batch(%s)：%s\n", simd ? "simd" : "标量", mismatches == 0 ? "一致" : "不一致");
+        failures += mismatches;
+    }
+    execute_moves_use_simd(true);
+    return failures;
+}
+
+// 当前存储格式下的启发式得分与double逐行计算的误差不超过格式的舍入误差，返回超差的棋盘数。
+// 每行的存储误差：double为0，float为相对2^-24，定点为2^-(HEUR_FIXED_SHIFT+1)；一个棋盘共8行
+static int check_heuristic(void) {
+    static const HeuristicConfig config = HEURISTIC_CONFIG_DEFAULT;
+    HeuristicPowers powers;
+    heuristic_powers_init(&config, &powers);
+
+#if GAME2048_HEUR_TABLE == 1
+    const char* format = "float";
+    const double row_rel = FLT_EPSILON / 2, row_abs = 0;
+#elif GAME2048_HEUR_TABLE == 2
+    const char* format = "定点";
+    const double row_rel = 0, row_abs = 1.0 / (2 << HEUR_FIXED_SHIFT);
+#else
+    const char* format = "double";
+    const double row_rel = 0, row_abs = 0;
+#endif
+
+    int failures = 0;
+    double max_error = 0;
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+        for (int move = 0; move < 4; move++) {
+            uint64_t board = execute_move(move, bench_corpus[i].board);
+            uint64_t board_t = transpose(board);
+            double expected = 0, tolerance = 0, magnitude = 0;
+            for (int r = 0; r < 4; r++) {
+                double row = heuristic_row_value((unsigned)(board >> (16 * r)) & ROW_MASK, &config, &powers);
+                double col = heuristic_row_value((unsigned)(board_t >> (16 * r)) & ROW_MASK, &config, &powers);
+                expected += row + col;
+                tolerance += (fabs(row) + fabs(col)) * row_rel + 2 * row_abs;
+                magnitude += fabs(row) + fabs(col);
+            }
+            // 8项求和本身的舍入误差
+            tolerance += magnitude * 8 * DBL_EPSILON;
+
+            double error = fabs(score_heur_board(board) - expected);
+            if (error > max_error) max_error = error;
+            if (error > tolerance) failures++;
+        }
+    }
+    printf("%s启发式表的误差：最大%.3g，%s\n", format, max_error, failures == 0 ? "在舍入误差以内" : "超出舍入误差");
+    return failures;
+}
+
+// 转置表的替换策略：同一个桶写满后，每次写入新棋盘淘汰的都应是剩余深度最小的条目。
+// 串行和无锁两种布局各检查一次，返回违反的次数
+static int check_tt(void) {
+    static const TTMode modes[] = { TT_MODE_SERIAL, TT_MODE_LOCKFREE };
+    static const char* mode_names[] = { "串行", "无锁" };
+    enum { NUM_KEYS = 12 };
+    int failures = 0;
+
+    for (int m = 0; m < 2; m++) {
+        // 最小的表只有两个桶，从小到大找出落在0号桶的棋盘
+        TransTable* table = create_trans_table(1);
+        if (!table || !trans_table_set_mode(table, modes[m])) {
+            fprintf(stderr, "无法创建转置表\n");
+            free_trans_table(table);
+            return 1;
+        }
+        unsigned shift = 63;
+        uint64_t keys[NUM_KEYS];
+        int depths[NUM_KEYS];
+        uint64_t key = 1;
+        for (int i = 0; i < NUM_KEYS; i++, key++) {
+            while (hash_function(key, shift) != 0) key++;
+            keys[i] = key;
+            depths[i] = (i * 7) % NUM_KEYS + 1;     // 互不相同且无序
+        }
+
+        bool present[NUM_KEYS] = { false };
+        int evictions = 0, wrong = 0;
+        for (int i = 0; i < NUM_KEYS; i++) {
+            insert_to_table(table, keys[i], depths[i], (double)i);
+            TransEntry entry;
+            // 新写入的条目总会占用槽位，只与留在桶中的旧条目比较
+            int min_depth = NUM_KEYS + 1;
+            int victim = -1;
+            for (int j = 0; j < i; j++) {
+                bool found = find_in_table(table, keys[j], &entry);
+                if (present[j] && !found) victim = j;
+                present[j] = found;
+                if (found && depths[j] < min_depth) min_depth = depths[j];
+            }
+            present[i] = find_in_table(table, keys[i], &entry);
+            if (victim >= 0) {
+                evictions++;
+                if (depths[victim] > min_depth) wrong++;
+            }
+        }
+        printf("转置表替换（%s）：淘汰%d次，%s\n", mode_names[m], evictions,
+               evictions > 0 && wrong == 0 ? "每次都淘汰剩余深度最小的条目" : "淘汰了更深的条目");
+        failures += evictions > 0 ? wrong : 1;
+        free_trans_table(table);
+    }
+    return failures;
+}
+
+#define SESSION_CHECK_ROUNDS 200        // 每种打断方式的轮数
+#define SESSION_CHECK_TIMEOUT 5.0       // 单轮等待的上限（秒），超过视为等待线程卡死
+
+typedef struct {
+    GameSession session;
+    atomic_int round;           // 主线程提交搜索后写入轮次，等待线程随即开始等待
+    atomic_int waiting;         // 等待线程即将调用session_search_wait的轮次
+    atomic_int finished;        // 等待线程已返回的轮次
+} SessionWaiter;
+
+static void sleep_briefly(void) {
+    struct timespec pause = { 0, 100000 };
+    nanosleep(&pause, NULL);
+}
+
+static void* session_wait_thread(void* arg) {
+    SessionWaiter* waiter = (SessionWaiter*)arg;
+    for (int round = 1; round <= SESSION_CHECK_ROUNDS; round++) {
+        while (atomic_load(&waiter->round) < round) sched_yield();
+        atomic_store(&waiter->waiting, round);
+        session_search_wait(waiter->session);
+        atomic_store(&waiter->finished, round);
+    }
+    return NULL;
+}
+
+// 会话的后台线程在首次提交时由提交线程创建并继承其调度策略。在SCHED_IDLE的辅助线程中
+// 首次提交，后台线程只在其余线程都睡眠时才运行，提交的搜索一直停留在待办中
+static void* session_idle_start_thread(void* arg) {
+#ifdef SCHED_IDLE
+    struct sched_param param = { 0 };
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+    session_search_start(*(GameSession*)arg, 1, 0);
+    return NULL;
+}
+
+// 一个线程在session_search_wait中等待后台搜索时，另一个线程移动、重新开局或取消，
+// 等待都应返回。最容易卡住的是待办的搜索在后台线程领取之前就被丢弃的情况，
+// 后台线程以SCHED_IDLE运行时每轮都是这种情况（其他平台上靠多轮重复命中）。
+// 卡住的等待线程无法回收，直接按失败返回
+static int check_session(void) {
+    static const char* action_names[] = { "移动", "重新开局", "取消" };
+
+    for (int action = 0; action < 3; action++) {
+        GameSession session = session_create(action + 1, 1 << 12);
+        // 卡住的等待线程在本函数返回后仍引用它，不能放在栈上
+        static SessionWaiter waiter;
+        waiter.session = session;
+        atomic_store(&waiter.round, 0);
+        atomic_store(&waiter.waiting, 0);
+        atomic_store(&waiter.finished, 0);
+        pthread_t thread;
+        if (session == GAME_SESSION_INVALID ||
+            pthread_create(&thread, NULL, session_idle_start_thread, &session) != 0) {
+            fprintf(stderr, "无法创建会话或线程\n");
+            return 1;
+        }
+        pthread_join(thread, NULL);
+        session_search_wait(session);
+        if (pthread_create(&thread, NULL, session_wait_thread, &waiter) != 0) {
+            fprintf(stderr, "无法创建线程\n");
+            return 1;
+        }
+
+        bool stuck = false;
+        for (int round = 1; round <= SESSION_CHECK_ROUNDS; round++) {
+            GameState state;
+            session_get_state(session, &state);
+            if (state.game_over) session_reset(session);
+
+            session_search_start(session, 2, 0);
+            atomic_store(&waiter.round, round);
+            while (atomic_load(&waiter.waiting) < round) sched_yield();
+            sched_yield();
+            switch (action) {
+                case 0: for (int dir = 0; dir < 4; dir++) session_move(session, dir, NULL); break;
+                case 1: session_reset(session); break;
+                case 2: session_search_cancel(session); break;
+            }
+
+            double deadline = now_seconds() + SESSION_CHECK_TIMEOUT;
+            while (atomic_load(&waiter.finished) < round && now_seconds() < deadline) {
+                sleep_briefly();
+            }
+            if (atomic_load(&waiter.finished) < round) {
+                stuck = true;
+                break;
+            }
+            // 让后台线程处理完被取消的搜索，下一轮从空闲开始
+            session_search_wait(session);
+        }
+        printf("等待后台搜索时%s：%s\n", action_names[action], stuck ? "等待线程卡住" : "等待全部返回");
+        if (stuck) return 1;
+        pthread_join(thread, NULL);
+        session_destroy(session);
+    }
+    return 0;
+}
+
+// 深度3/5的最佳方向与语料记录一致，返回不一致的棋盘数
+static int check_corpus(void) {
+    int failures = 0;
+    SearchContext* ctx = search_context_create(TRANSTABLE_SIZE);
+    if (!ctx) {
+        fprintf(stderr, "无法创建搜索上下文\n");
+        return 1;
+    }
+    static const int depths[] = { 3, 5 };
+    for (int d = 0; d < 2; d++) {
+        int matches = 0;
+        for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+            GameState state = { bench_corpus[i].board, 0, 0, false };
+            int expected = depths[d] == 3 ? bench_corpus[i].best_move_d3 : bench_corpus[i].best_move_d5;
+            if (find_best_move_ctx(ctx, &state, depths[d]) == expected) matches++;
+        }
+        printf("深度%d最佳方向与语料一致：%d/%d\n", depths[d], matches, BENCH_CORPUS_SIZE);
+        failures += BENCH_CORPUS_SIZE - matches;
+    }
+    search_context_destroy(ctx);
+    return failures;
+}
+
+// 正确性检查，what为NULL时执行全部检查；全部通过时返回0，供ctest使用
+static int bench_check(const char* what) {
+    static const struct {
+        const char* name;
+        int (*run)(void);
+    } checks[] = {
+        { "tables", check_tables },
+        { "heuristic", check_heuristic },
+        { "tt", check_tt },
+        { "session", check_session },
+        { "corpus", check_corpus },
+    };
+    enum { NUM_CHECKS = sizeof(checks) / sizeof(checks[0]) };
+
+    init_tables();
+    int failures = 0;
+    bool found = false;
+    for (int i = 0; i < NUM_CHECKS; i++) {
+        if (what && strcmp(what, checks[i].name) != 0) continue;
+        found = true;
+        failures += checks[i].run();
+    }
+    if (!found) {
+        fprintf(stderr, "未知的检查项：%s\n", what);
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+static void copy_report(const SearchReport* report, void* user) {
+    *(SearchReport*)user = *report;
+}
+
+// 机会节点展开方式的速度和质量对比，以精确展开为基准
+static int bench_sampling(int depth) {
+    static const struct {
+        const char* name;
+        SampleMode mode;
+        int max_samples;
+    } modes[] = {
+        { "exact", SAMPLE_EXACT, 0 },
+        { "stochastic/4", SAMPLE_STOCHASTIC, 4 },
+        { "stochastic/8", SAMPLE_STOCHASTIC, 8 },
+        { "legacy", SAMPLE_LEGACY, 0 },
+    };
+    enum { NUM_MODES = sizeof(modes) / sizeof(modes[0]) };
+
+    init_tables();
+    SearchContext* ctx = search_context_create(TRANSTABLE_SIZE);
+    if (!ctx) {
+        fprintf(stderr, "无法创建搜索上下文\n");
+        return 1;
+    }
+
+    SearchReport report;
+    search_context_set_report_callback(ctx, copy_report, &report);
+
+    // 先算出精确展开下每个棋盘各方向的得分，这一轮同时预热转置表，不计时
+    static SearchReport exact[BENCH_CORPUS_SIZE];
+    search_context_set_sampling(ctx, SAMPLE_EXACT, 0);
+    for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+        GameState state = { bench_corpus[i].board, 0, 0, false };
+        find_best_move_ctx(ctx, &state, depth);
+        exact[i] = report;
+    }
+
+    printf("机会节点展开方式：%d个语料棋盘，深度%d\n", BENCH_CORPUS_SIZE, depth);
+    printf("%-14s %10s %14s %10s %12s %12s\n", "方式", "ms/步", "节点/步", "方向一致", "平均损失", "最大损失");
+    for (int m = 0; m < NUM_MODES; m++) {
+        search_context_set_sampling(ctx, modes[m].mode, modes[m].max_samples);
+
+        long long nodes = 0;
+        int searched = 0, agree = 0;
+        double loss_sum = 0, loss_max = 0;
+        double start = now_seconds();
+        for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+            GameState state = { bench_corpus[i].board, 0, 0, false };
+            int move = find_best_move_ctx(ctx, &state, depth);
+            if (move < 0) continue;
+
+            searched++;
+            nodes += report.stats.moves_evaled;
+            if (move == exact[i].best_move) agree++;
+            // 按精确得分，所选方向比最佳方向差多少（相对值）
+            double loss = (exact[i].best_score - exact[i].move_scores[move]) / exact[i].best_score;
+            loss_sum += loss;
+            if (loss > loss_max) loss_max = loss;
+        }
+        double elapsed = now_seconds() - start;
+        if (searched == 0) searched = 1;
+
+        printf("%-14s %10.3f %14.0f %9d/%d %11.4f%% %11.4f%%\n", modes[m].name,
+               elapsed * 1e3 / searched, (double)nodes / searched, agree, searched,
+               loss_sum / searched * 100, loss_max * 100);
+    }
+
+    search_context_destroy(ctx);
+    return 0;
+}
+
+// 转置表对称合并的效果：同一语料分别关闭和开启对称合并搜索
+static int bench_symmetry(int max_depth) {
+    init_tables();
+    SearchContext* ctx = search_context_create(TRANSTABLE_SIZE);
+    if (!ctx) {
+        fprintf(stderr, "无法创建搜索上下文\n");
+        return 1;
+    }
+
+    SearchReport report;
+    search_context_set_report_callback(ctx, copy_report, &report);
+    static int moves_off[BENCH_CORPUS_SIZE];
+
+    printf("转置表对称合并：%d个语料棋盘\n", BENCH_CORPUS_SIZE);
+    printf("%-6s %-6s %10s %14s %10s %10s\n", "深度", "对称", "ms/步", "节点/步", "命中率", "方向一致");
+    for (int depth = 2; depth <= max_depth; depth++) {
+        for (int sym = 0; sym < 2; sym++) {
+            search_context_set_tt_symmetry(ctx, sym);
+
+            long long nodes = 0, hits = 0, probes = 0;
+            int searched = 0, agree = 0;
+            double start = now_seconds();
+            for (int i = 0; i < BENCH_CORPUS_SIZE; i++) {
+                GameState state = { bench_corpus[i].board, 0, 0, false };
+                int move = find_best_move_ctx(ctx, &state, depth);
+                if (move < 0) continue;
+                searched++;
+                nodes += report.stats.moves_evaled;
+                hits += report.stats.tt_hits;
+                probes += report.stats.tt_probes;
+                if (sym == 0) moves_off[i] = move;
+                else if (move == moves_off[i]) agree++;
+            }
+            double elapsed = now_seconds() - start;
+            if (searched == 0) searched = 1;
+
+            printf("%-6d %-6s %10.3f %14.0f %9.2f%%", depth, sym ? "开" : "关",
+                   elapsed * 1e3 / searched, (double)nodes / searched,
+                   probes > 0 ? 100.0 * hits / probes : 0.0);
+            if (sym) printf(" %8d/%d", agree, searched);
+            printf("\n");
+        }
+    }
+
+    search_context_destroy(ctx);
+    return 0;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "用法: %s micro [轮数] [最大搜索深度]\n", prog);
+    fprintf(stderr, "      %s tt [最大线程数] [每线程操作数]\n", prog);
+    fprintf(stderr, "      %s hash [基础棋盘数]\n", prog);
+    fprintf(stderr, "      %s check [tables|heuristic|tt|session|corpus]\n", prog);
+    fprintf(stderr, "      %s sampling [搜索深度]\n", prog);
+    fprintf(stderr, "      %s symmetry [最大搜索深度]\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "micro") == 0) {
+        int rounds = argc > 2 ? atoi(argv[2]) : 100000;
+        int max_depth = argc > 3 ? atoi(argv[3]) : 5;
+        if (rounds < 1) rounds = 1;
+        return bench_micro(rounds, max_depth);
+    }
+
+    if (strcmp(argv[1], "tt") == 0) {
+        int max_threads = argc > 2 ? atoi(argv[2]) : thread_pool_cpu_count();
+        long ops = argc > 3 ? atol(argv[3]) : 2000000;
+        if (max_threads < 1) max_threads = 1;
+        if (max_threads > 256) max_threads = 256;
+        return bench_tt(max_threads, ops);
+    }
+
+    if (strcmp(argv[1], "hash") == 0) {
+        int num_bases = argc > 2 ? atoi(argv[2]) : 200000;
+        if (num_bases < 1) num_bases = 1;
+        return bench_hash(num_bases);
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+        return bench_check(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "sampling") == 0) {
+        int depth = argc > 2 ? atoi(argv[2]) : 3;
+        if (depth < 1) depth = 1;
+        return bench_sampling(depth);
+    }
+
+    if (strcmp(argv[1], "symmetry") == 0) {
+        int max_depth = argc > 2 ? atoi(argv[2]) : 5;
+        if (max_depth < 2) max_depth = 2;
+        return bench_symmetry(max_depth);
+    }
+
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,102 @@
+// game2048_bench_corpus.h - 基准测试用的固定棋盘语料
+//
+// 取自对局各个阶段的棋盘（含2个已结束的棋盘），附带深度3和深度5固定深度搜索的
+// 最佳方向（用double启发式表、默认的精确展开记录），用于发现改动是否改变了搜索结果。
+// 改变搜索语义时需重新记录。
+#ifndef GAME2048_BENCH_CORPUS_H
+#define GAME2048_BENCH_CORPUS_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t board;
+    int best_move_d3;           // 深度3搜索的最佳方向，-1表示无法移动
+    int best_move_d5;           // 深度5搜索的最佳方向
+} BenchBoard;
+
+static const BenchBoard bench_corpus[] = {
+    { 0x0200014200232426ULL, LEFT, LEFT },
+    { 0x1002002701220562ULL, DOWN, DOWN },
+    { 0x2134004601330321ULL, DOWN, DOWN },
+    { 0x1231015224343241ULL, RIGHT, RIGHT },
+    { 0x0002002411351352ULL, LEFT, UP },
+    { 0x0342112303423415ULL, RIGHT, RIGHT },
+    { 0x0013003122453252ULL, UP, UP },
+    { 0x0224035112744232ULL, UP, RIGHT },
+    { 0x0031112500251215ULL, LEFT, LEFT },
+    { 0x1234314226361351ULL, -1, -1 },
+    { 0x0042113521520014ULL, RIGHT, RIGHT },
+    { 0x1035023115724124ULL, DOWN, DOWN },
+    { 0x0021001220240326ULL, UP, UP },
+    { 0x2214135124643253ULL, LEFT, LEFT },
+    { 0x0204000602320041ULL, DOWN, DOWN },
+    { 0x1200142014522341ULL, LEFT, LEFT },
+    { 0x1034022323723521ULL, LEFT, LEFT },
+    { 0x0100000401250261ULL, DOWN, DOWN },
+    { 0x0353037500132312ULL, DOWN, UP },
+    { 0x0035104102521413ULL, DOWN, LEFT },
+    { 0x0233013400511125ULL, DOWN, DOWN },
+    { 0x0003101302317362ULL, LEFT, RIGHT },
+    { 0x1342135207611262ULL, RIGHT, RIGHT },
+    { 0x0212023513562384ULL, DOWN, UP },
+    { 0x1213023300140226ULL, LEFT, LEFT },
+    { 0x0113023142522324ULL, UP, RIGHT },
+    { 0x1243256523431215ULL, UP, UP },
+    { 0x1034002323523141ULL, UP, UP },
+    { 0x0341003433152323ULL, DOWN, RIGHT },
+    { 0x0034022511710235ULL, RIGHT, RIGHT },
+    { 0x2120231014604313ULL, LEFT, LEFT },
+    { 0x0211014504711513ULL, DOWN, DOWN },
+    { 0x0142024213580413ULL, RIGHT, RIGHT },
+    { 0x2006013103440122ULL, UP, DOWN },
+    { 0x0004033324452421ULL, LEFT, LEFT },
+    { 0x1013003442512134ULL, LEFT, DOWN },
+    { 0x0001001201620434ULL, UP, UP },
+    { 0x0012101300460044ULL, LEFT, LEFT },
+    { 0x1343002230030006ULL, LEFT, LEFT },
+    { 0x0214034212340157ULL, UP, UP },
+    { 0x2424145335152167ULL, DOWN, DOWN },
+    { 0x0120267414152267ULL, LEFT, LEFT },
+    { 0x0241013402453414ULL, DOWN, DOWN },
+    { 0x0000010001213426ULL, UP, UP },
+    { 0x1331234234241256ULL, LEFT, DOWN },
+    { 0x0003001410230146ULL, UP, UP },
+    { 0x0002125323612416ULL, DOWN, RIGHT },
+    { 0x0002011302343453ULL, LEFT, RIGHT },
+    { 0x0003123502371152ULL, DOWN, DOWN },
+    { 0x0101122223173573ULL, RIGHT, DOWN },
+    { 0x1003032622341322ULL, UP, UP },
+    { 0x0000001300261135ULL, LEFT, LEFT },
+    { 0x0232032421723415ULL, DOWN, DOWN },
+    { 0x0313102103450314ULL, UP, UP },
+    { 0x1000041315353312ULL, RIGHT, RIGHT },
+    { 0x1212002500332357ULL, UP, DOWN },
+    { 0x2112043402230016ULL, LEFT, LEFT },
+    { 0x1333414324573210ULL, UP, UP },
+    { 0x0000100122621521ULL, DOWN, DOWN },
+    { 0x1313213413723523ULL, -1, -1 },
+    { 0x3243452503210102ULL, UP, UP },
+    { 0x1424246354101621ULL, LEFT, LEFT },
+    { 0x0002201402361153ULL, LEFT, UP },
+    { 0x0000134025624635ULL, LEFT, LEFT },
+    { 0x0032012331352354ULL, DOWN, DOWN },
+    { 0x2243231426363152ULL, RIGHT, RIGHT },
+    { 0x0002001423241345ULL, UP, UP },
+    { 0x0001004201140346ULL, DOWN, DOWN },
+    { 0x0304042215363261ULL, DOWN, DOWN },
+    { 0x0231021245233152ULL, DOWN, DOWN },
+    { 0x0121313512614536ULL, UP, DOWN },
+    { 0x0313331302360001ULL, DOWN, DOWN },
+    { 0x0125030301252251ULL, LEFT, UP },
+    { 0x0003002504270453ULL, DOWN, DOWN },
+    { 0x0324101401571473ULL, DOWN, DOWN },
+    { 0x3131034734181234ULL, UP, DOWN },
+    { 0x0002012104260204ULL, LEFT, LEFT },
+    { 0x3052236535131421ULL, LEFT, LEFT },
+    { 0x0014100305410342ULL, UP, UP },
+    { 0x2421112525611235ULL, UP, UP },
+};
+
+#define BENCH_CORPUS_SIZE ((int)(sizeof(bench_corpus) / sizeof(bench_corpus[0])))
+
+#endif // GAME2048_BENCH_CORPUS_H
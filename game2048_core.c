@@ -5,126 +5,301 @@
 #include <math.h>
 #include <time.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 #include "game2048.h"
+#include "game2048_pool.h"
+#include "game2048_arena.h"
+#include "game2048_log.h"
+#include "game2048_tables.h"
+
+// x86上用GCC/Clang编译时提供AVX2批量走子，运行时检测CPU后启用
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HAVE_AVX2_MOVES 1
+#endif
 
 // 添加max宏定义
 #define max(a,b) ((a) > (b) ? (a) : (b))
 #define min(a,b) ((a) < (b) ? (a) : (b))
 
 // 函数前向声明
-double score_tilechoose_node(EvalState *state, uint64_t board, double cprob);
-double score_move_node(EvalState *state, uint64_t board, double cprob);
+double score_tilechoose_node(EvalState *state, uint64_t board, uint64_t board_t, double cprob);
+double score_move_node(EvalState *state, uint64_t board, uint64_t board_t, double cprob);
 double score_heur_board(uint64_t board);
 
-// 移动表和得分表
-static uint64_t row_left_table[ROW_MAX];
-static uint64_t row_right_table[ROW_MAX];
-static uint64_t col_up_table[ROW_MAX];
-static uint64_t col_down_table[ROW_MAX];
-static double heur_score_table[ROW_MAX];
-static double score_table[ROW_MAX];
-
-// 哈希表实现 (简化版)
-typedef struct TransEntry {
-    uint64_t key;
-    int depth;
-    double score;
-    struct TransEntry* next;
-} TransEntry;
+// 移动表和得分表，存储格式见game2048_tables.h
+#if GAME2048_PREBUILT_TABLES
+// 构建时由game2048_gentables生成的只读数据，无需启动时计算，多进程共享只读页
+#include "game2048_tables_data.inc"
+#else
+#if GAME2048_COMPACT_MOVES
+// row_deltas[0][行]为LEFT、[1][行]为RIGHT的行异或差，共256KB；
+// UP/DOWN的列异或差是其列展开
+static uint16_t row_deltas[2][ROW_DELTA_STRIDE];
+#else
+// move_tables[方向][行]：该行（UP/DOWN为转置后的列）移动前后的异或差，
+// 四个方向连续存放，便于SIMD一次gather四个方向
+static uint64_t move_tables[4][ROW_MAX];
+#endif
+static heur_t heur_score_table[ROW_MAX];
+static uint32_t score_table[ROW_MAX];
+#endif
 
-typedef struct {
-    TransEntry** entries;
-    size_t size;
-    size_t count;
-} TransTable;
-
-// 创建转置表
-TransTable* create_trans_table(size_t size) {
-    TransTable* table = (TransTable*)malloc(sizeof(TransTable));
-    if (!table) return NULL;
-    
-    table->size = size;
-    table->count = 0;
-    table->entries = (TransEntry**)calloc(size, sizeof(TransEntry*));
-    if (!table->entries) {
-        free(table);
+// 机会节点默认的并行展开深度：根节点（深度0）和下一层机会节点的子节点作为任务分发
+#define DEFAULT_PARALLEL_DEPTH 2
+
+// 机会节点默认的展开方式
+#define DEFAULT_SAMPLE_MODE SAMPLE_EXACT
+
+// 转置表默认不合并对称棋盘：精确展开已合并对称空位，整局下来节点数只少约1%
+#define DEFAULT_TT_SYMMETRY false
+
+#define MAX_SEARCH_DEPTH 15         // 搜索深度上限
+_Static_assert(MAX_SEARCH_DEPTH < SEARCH_STATS_DEPTHS, "按层统计必须覆盖全部搜索深度");
+#define DEADLINE_POLL_INTERVAL 256  // 每访问这么多机会节点检查一次时钟和取消标志
+
+// 搜索的截止时间和取消标志，由同一次搜索的所有线程共享
+struct SearchDeadline {
+    double deadline_ms;         // now_ms()时间轴上的截止时刻，不限时为INFINITY
+    const atomic_bool* cancel;  // 上下文的取消标志，与时钟一起轮询
+    atomic_bool expired;        // 任一线程发现超时后置位，其余线程随即返回
+};
+
+// 搜索上下文：持有跨多次搜索复用的转置表和并行搜索线程池
+struct SearchContext {
+    TransTable* trans_table;
+    ThreadPool* pool;           // NULL表示串行搜索
+    int parallel_depth;         // 并行展开机会节点的深度上限
+    TTMode parallel_tt_mode;    // 并行搜索时转置表的并发方式
+    SearchReportFunc report;    // 每次搜索结束时的统计回调，NULL表示不回调
+    void* report_user;
+    const HeuristicTable* heuristic;    // 启发式表，NULL表示默认表；不归上下文所有
+    SampleMode sample_mode;     // 机会节点的展开方式
+    int max_samples;            // 抽样模式下最多展开的空位数
+    bool tt_symmetry;           // 转置表是否按对称规范形式存取
+    SearchStats last_stats;     // 最近一次搜索的统计
+    atomic_bool cancel;         // 置位时正在进行的搜索尽快中止，之后的搜索直接返回
+};
+
+// 创建搜索上下文，table_size为转置表期望槽位数
+SearchContext* search_context_create(size_t table_size) {
+    SearchContext* ctx = (SearchContext*)malloc(sizeof(SearchContext));
+    if (!ctx) return NULL;
+
+    ctx->trans_table = create_trans_table(table_size);
+    if (!ctx->trans_table) {
+        free(ctx);
         return NULL;
     }
-    
-    return table;
-}
+    ctx->pool = NULL;           // 默认串行，多线程结果不保证与串行相同，需显式启用
+    ctx->parallel_depth = DEFAULT_PARALLEL_DEPTH;
+    ctx->parallel_tt_mode = TT_MODE_LOCKFREE;
+    ctx->report = NULL;
+    ctx->report_user = NULL;
+    ctx->heuristic = NULL;
+    ctx->sample_mode = DEFAULT_SAMPLE_MODE;
+    ctx->max_samples = DEFAULT_MAX_SAMPLES;
+    ctx->tt_symmetry = DEFAULT_TT_SYMMETRY;
+    memset(&ctx->last_stats, 0, sizeof(ctx->last_stats));
+    atomic_init(&ctx->cancel, false);
 
-// 简易哈希函数
-size_t hash_function(uint64_t key, size_t size) {
-    // 简单的哈希函数：取模
-    return key % size;
+    return ctx;
 }
 
-// 在转置表中查找
-TransEntry* find_in_table(TransTable* table, uint64_t key) {
-    size_t index = hash_function(key, table->size);
-    TransEntry* entry = table->entries[index];
-    
-    while (entry != NULL) {
-        if (entry->key == key) {
-            return entry;
+// 设置搜索线程数：1为串行搜索，<=0使用全部CPU核心。
+// 多线程时根节点的各个方向作为任务分发到工作窃取线程池，共享并发转置表；
+// 转置表的内容取决于各任务完成的先后，结果不保证与串行相同（见game2048.h）
+bool search_context_set_threads(SearchContext* ctx, int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = thread_pool_cpu_count();
+    }
+
+    thread_pool_destroy(ctx->pool);
+    ctx->pool = NULL;
+
+    if (num_threads > 1) {
+        if (!trans_table_set_mode(ctx->trans_table, ctx->parallel_tt_mode)) return false;
+        ctx->pool = thread_pool_create(num_threads);
+        if (!ctx->pool) {
+            trans_table_set_mode(ctx->trans_table, TT_MODE_SERIAL);
+            return false;
         }
-        entry = entry->next;
+    } else {
+        trans_table_set_mode(ctx->trans_table, TT_MODE_SERIAL);
     }
-    
-    return NULL;
+
+    return true;
 }
 
-// 向转置表中插入
-void insert_to_table(TransTable* table, uint64_t key, int depth, double score) {
-    size_t index = hash_function(key, table->size);
-    
-    // 检查是否已存在
-    TransEntry* existing = find_in_table(table, key);
-    if (existing) {
-        // 更新现有条目
-        existing->depth = depth;
-        existing->score = score;
-        return;
+// 设置并行搜索时转置表的并发方式（默认无锁），TT_MODE_SERIAL无效
+bool search_context_set_parallel_tt_mode(SearchContext* ctx, TTMode mode) {
+    if (mode == TT_MODE_SERIAL) return false;
+
+    ctx->parallel_tt_mode = mode;
+    if (ctx->pool) {
+        return trans_table_set_mode(ctx->trans_table, mode);
     }
-    
-    // 创建新条目
-    TransEntry* entry = (TransEntry*)malloc(sizeof(TransEntry));
-    if (!entry) return;
-    
-    entry->key = key;
-    entry->depth = depth;
-    entry->score = score;
-    entry->next = table->entries[index];
-    table->entries[index] = entry;
-    table->count++;
+    return true;
 }
 
-// 释放转置表
-void free_trans_table(TransTable* table) {
-    if (!table) return;
-    
-    for (size_t i = 0; i < table->size; i++) {
-        TransEntry* entry = table->entries[i];
-        while (entry) {
-            TransEntry* next = entry->next;
-            free(entry);
-            entry = next;
-        }
+// 设置并行展开深度：深度小于depth的机会节点把子节点作为任务交给线程池，
+// 更深的子树在各线程内串行搜索。0表示只并行根节点的各个方向
+void search_context_set_parallel_depth(SearchContext* ctx, int depth) {
+    ctx->parallel_depth = depth < 0 ? 0 : depth;
+}
+
+// 设置搜索统计回调：每次find_best_move_ctx/find_best_move_timed结束时在调用线程中回调
+void search_context_set_report_callback(SearchContext* ctx, SearchReportFunc func, void* user) {
+    ctx->report = func;
+    ctx->report_user = user;
+}
+
+// 设置搜索使用的启发式表，NULL恢复默认表。表由调用方持有，须在上下文不再使用它之前保持有效。
+// 转置表中按旧表算出的得分随即换代作废
+void search_context_set_heuristic(SearchContext* ctx, const HeuristicTable* table) {
+    if (ctx->heuristic != table) {
+        ctx->heuristic = table;
+        trans_table_new_generation(ctx->trans_table);
     }
-    
-    free(table->entries);
-    free(table);
 }
 
-// 位操作辅助函数
-static uint64_t reverse_row(uint64_t row) {
-    return ((row >> 12) & 0xF) | ((row >> 4) & 0xF0) | ((row << 4) & 0xF00) | ((row << 12) & 0xF000);
+// 设置机会节点的展开方式；max_samples只对SAMPLE_STOCHASTIC有效，<=0使用默认值。
+// 不同方式的得分不可混用，切换后转置表换代
+void search_context_set_sampling(SearchContext* ctx, SampleMode mode, int max_samples) {
+    if (max_samples <= 0) max_samples = DEFAULT_MAX_SAMPLES;
+    if (max_samples > 16) max_samples = 16;
+    if (ctx->sample_mode != mode || ctx->max_samples != max_samples) {
+        ctx->sample_mode = mode;
+        ctx->max_samples = max_samples;
+        trans_table_new_generation(ctx->trans_table);
+    }
+}
+
+// 转置表按棋盘的对称规范形式存取，旋转、镜像得到的棋盘共用表项。
+// 只有精确展开时等价棋盘的得分才严格相同；抽样展开下抽到的空位随朝向不同，
+// 复用的是另一朝向的估计值。键的含义改变，切换后转置表换代
+void search_context_set_tt_symmetry(SearchContext* ctx, bool enable) {
+    if (ctx->tt_symmetry != enable) {
+        ctx->tt_symmetry = enable;
+        trans_table_new_generation(ctx->trans_table);
+    }
+}
+
+// 取消搜索：置位后正在进行的搜索（可在其他线程中）在下一次轮询时钟时中止并返回-1，
+// 之后的搜索也立即返回-1，直到清除。这是上下文中唯一可以跨线程调用的设置
+void search_context_set_cancel(SearchContext* ctx, bool cancel) {
+    atomic_store(&ctx->cancel, cancel);
 }
 
-static uint64_t unpack_col(uint64_t row) {
-    return ((row & 0xF) | ((row & 0xF0) << 12) |
-            ((row & 0xF00) << 24) | ((row & 0xF000) << 36));
+static bool search_cancelled(SearchContext* ctx) {
+    return atomic_load_explicit(&ctx->cancel, memory_order_relaxed);
+}
+
+// 最近一次搜索（固定深度或限时）的统计；无法移动而未搜索时全部为0
+void search_context_last_stats(const SearchContext* ctx, SearchStats* out) {
+    *out = ctx->last_stats;
+}
+
+// 把add累加到total：计数相加，最大深度取较大者，用时相加
+void search_stats_merge(SearchStats* total, const SearchStats* add) {
+    for (int d = 0; d < SEARCH_STATS_DEPTHS; d++) {
+        total->chance_nodes[d] += add->chance_nodes[d];
+        total->move_nodes[d] += add->move_nodes[d];
+    }
+    total->moves_evaled += add->moves_evaled;
+    total->heuristic_evals += add->heuristic_evals;
+    total->cprob_prunes += add->cprob_prunes;
+    total->depth_cutoffs += add->depth_cutoffs;
+    total->tt_probes += add->tt_probes;
+    total->tt_hits += add->tt_hits;
+    total->tt_inserts += add->tt_inserts;
+    total->tt_updates += add->tt_updates;
+    total->tt_evictions += add->tt_evictions;
+    total->tt_collisions += add->tt_collisions;
+    total->maxdepth = max(total->maxdepth, add->maxdepth);
+    total->elapsed_ms += add->elapsed_ms;
+}
+
+static double percent(uint64_t part, uint64_t whole) {
+    return whole > 0 ? 100.0 * part / whole : 0.0;
+}
+
+void search_stats_print(const SearchStats* stats) {
+    uint64_t chance = 0, move = 0;
+    for (int d = 0; d < SEARCH_STATS_DEPTHS; d++) {
+        chance += stats->chance_nodes[d];
+        move += stats->move_nodes[d];
+    }
+    printf("搜索统计：用时%.1fms，最大深度%d，执行移动%llu次（%.0f次/秒），启发式评估%llu次\n",
+           stats->elapsed_ms, stats->maxdepth, (unsigned long long)stats->moves_evaled,
+           stats->elapsed_ms > 0 ? stats->moves_evaled / stats->elapsed_ms * 1e3 : 0.0,
+           (unsigned long long)stats->heuristic_evals);
+    printf("  机会节点%llu个：概率截断%llu（%.1f%%），深度截断%llu\n",
+           (unsigned long long)chance, (unsigned long long)stats->cprob_prunes,
+           percent(stats->cprob_prunes, chance), (unsigned long long)stats->depth_cutoffs);
+    printf("  转置表：查找%llu次，命中%llu次（%.1f%%）；写入空槽%llu、更新%llu、覆盖旧代%llu、冲突淘汰%llu\n",
+           (unsigned long long)stats->tt_probes, (unsigned long long)stats->tt_hits,
+           percent(stats->tt_hits, stats->tt_probes), (unsigned long long)stats->tt_inserts,
+           (unsigned long long)stats->tt_updates, (unsigned long long)stats->tt_evictions,
+           (unsigned long long)stats->tt_collisions);
+    printf("  %-6s %14s %14s %8s\n", "层", "机会节点", "max节点", "占比");
+    for (int d = 0; d < SEARCH_STATS_DEPTHS; d++) {
+        if (stats->chance_nodes[d] == 0 && stats->move_nodes[d] == 0) continue;
+        printf("  %-6d %14llu %14llu %7.1f%%\n", d, (unsigned long long)stats->chance_nodes[d],
+               (unsigned long long)stats->move_nodes[d], percent(stats->move_nodes[d], move));
+    }
+}
+
+// 上下文持有的转置表，用于开启统计、切换哈希方式等；不能在搜索进行时修改
+TransTable* search_context_table(SearchContext* ctx) {
+    return ctx->trans_table;
+}
+
+// 销毁搜索上下文
+void search_context_destroy(SearchContext* ctx) {
+    if (!ctx) return;
+
+    thread_pool_destroy(ctx->pool);
+    free_trans_table(ctx->trans_table);
+    free(ctx);
+}
+
+// 单调时钟，单位毫秒
+static double now_ms(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER counter;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1.0e6;
+#endif
+}
+
+// 限时搜索是否已中止；每DEADLINE_POLL_INTERVAL个节点才读一次时钟
+static bool search_expired(EvalState *state) {
+    SearchDeadline *deadline = state->deadline;
+    if (!deadline) return false;
+    if (atomic_load_explicit(&deadline->expired, memory_order_relaxed)) return true;
+    if (--state->poll_countdown > 0) return false;
+
+    state->poll_countdown = DEADLINE_POLL_INTERVAL;
+    if (atomic_load_explicit(deadline->cancel, memory_order_relaxed) ||
+        now_ms() >= deadline->deadline_ms) {
+        atomic_store_explicit(&deadline->expired, true, memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+static bool search_aborted(const EvalState *state) {
+    return state->deadline && atomic_load_explicit(&state->deadline->expired, memory_order_relaxed);
 }
 
 int get_max_rank(uint64_t board) {
@@ -137,134 +312,99 @@ int get_max_rank(uint64_t board) {
     return maxrank;
 }
 
-// 初始化表格
+// 初始化表格：预生成表时只需选择批量走子的实现
 void init_tables(void) {
+#if !GAME2048_PREBUILT_TABLES
+    static const HeuristicConfig config = HEURISTIC_CONFIG_DEFAULT;
+    HeuristicPowers powers;
+    heuristic_powers_init(&config, &powers);
+
     for (unsigned row = 0; row < ROW_MAX; row++) {
-        unsigned line[4] = {
-            (row >> 0) & 0xf,
-            (row >> 4) & 0xf,
-            (row >> 8) & 0xf,
-            (row >> 12) & 0xf
-        };
-
-        // 分数表计算
-        double score = 0.0;
-        for (int i = 0; i < 4; i++) {
-            unsigned rank = line[i];
-            if (rank >= 2) {
-                score += (rank - 1) * (1 << rank);
-            }
+        TableRow info;
+        table_row_generate(row, &config, &powers, &info);
+        heur_score_table[row] = info.heur;
+        score_table[row] = info.score;
+#if GAME2048_COMPACT_MOVES
+        row_deltas[0][row] = (uint16_t)info.delta[LEFT];
+        row_deltas[1][row] = (uint16_t)info.delta[RIGHT];
+#else
+        for (int dir = 0; dir < 4; dir++) {
+            move_tables[dir][row] = info.delta[dir];
         }
-        score_table[row] = score;
-
-        // 启发式分数计算
-        double sum = 0;
-        int empty = 0;
-        int merges = 0;
-        int prev = 0;
-        int counter = 0;
+#endif
+    }
+#endif
 
-        for (int i = 0; i < 4; i++) {
-            unsigned rank = line[i];
-            sum += pow(rank, SCORE_SUM_POWER);
-            if (rank == 0) {
-                empty++;
-            } else {
-                if (prev == rank) {
-                    counter++;
-                } else if (counter > 0) {
-                    merges += 1 + counter;
-                    counter = 0;
-                }
-                prev = rank;
-            }
-        }
-        if (counter > 0) merges += 1 + counter;
+    execute_moves_use_simd(true);
+}
 
-        double monotonicity_left = 0, monotonicity_right = 0;
-        for (int i = 1; i < 4; i++) {
-            if (line[i-1] > line[i]) {
-                monotonicity_left += pow(line[i-1], SCORE_MONOTONICITY_POWER) - pow(line[i], SCORE_MONOTONICITY_POWER);
-            } else {
-                monotonicity_right += pow(line[i], SCORE_MONOTONICITY_POWER) - pow(line[i-1], SCORE_MONOTONICITY_POWER);
-            }
-        }
+// 逐行比较当前使用的表与运行时生成的结果，返回不一致的行数
+int verify_tables(void) {
+    static const HeuristicConfig config = HEURISTIC_CONFIG_DEFAULT;
+    HeuristicPowers powers;
+    heuristic_powers_init(&config, &powers);
 
-        heur_score_table[row] = SCORE_LOST_PENALTY +
-                              SCORE_EMPTY_WEIGHT * empty +
-                              SCORE_MERGES_WEIGHT * merges -
-                              SCORE_MONOTONICITY_WEIGHT * fmin(monotonicity_left, monotonicity_right) -
-                              SCORE_SUM_WEIGHT * sum;
-
-        // 关键修改：合并逻辑限制到MAX_RANK (2048)
-        unsigned result_line[4] = {line[0], line[1], line[2], line[3]};
-        int i = 0;
-        while (i < 3) {
-            int j = i + 1;
-            while (j < 4 && result_line[j] == 0) j++;  // 跳过右侧空位
-            if (j == 4) break;  // 没有更多砖块
-
-            if (result_line[i] == 0) {  // 移动空位到左侧
-                result_line[i] = result_line[j];
-                result_line[j] = 0;
-                i--;  // 重新检查当前位置
-            } else if (result_line[i] == result_line[j] && result_line[i] < MAX_RANK) {  // 合并条件：相同且小于MAX_RANK
-                result_line[i]++;  // 合并后的等级+1（比如10->11）
-                result_line[j] = 0;  // 清除右侧砖块
-            }
-            i++;
+    int mismatches = 0;
+    for (unsigned row = 0; row < ROW_MAX; row++) {
+        TableRow info;
+        table_row_generate(row, &config, &powers, &info);
+        bool same = memcmp(&heur_score_table[row], &info.heur, sizeof(heur_t)) == 0 &&
+                    score_table[row] == info.score;
+#if GAME2048_COMPACT_MOVES
+        same = same && row_deltas[0][row] == info.delta[LEFT] && row_deltas[1][row] == info.delta[RIGHT];
+#else
+        for (int dir = 0; dir < 4; dir++) {
+            same = same && move_tables[dir][row] == info.delta[dir];
         }
+#endif
+        if (!same) mismatches++;
+    }
+    return mismatches;
+}
 
-        // 生成移动表
-        uint64_t result = (result_line[0] << 0) | (result_line[1] << 4) | 
-                         (result_line[2] << 8) | (result_line[3] << 12);
-        uint64_t rev_result = reverse_row(result);
-        uint64_t rev_row = reverse_row(row);
+// 棋盘x的四行各自向LEFT/RIGHT移动的异或差
+static inline uint64_t rows_delta(int dir, uint64_t x) {
+    unsigned r0 = (x >> 0) & ROW_MASK;
+    unsigned r1 = (x >> 16) & ROW_MASK;
+    unsigned r2 = (x >> 32) & ROW_MASK;
+    unsigned r3 = (x >> 48) & ROW_MASK;
+#if GAME2048_COMPACT_MOVES
+    const uint16_t *table = row_deltas[dir == RIGHT];
+    return ((uint64_t)table[r0] << 0) ^ ((uint64_t)table[r1] << 16) ^
+           ((uint64_t)table[r2] << 32) ^ ((uint64_t)table[r3] << 48);
+#else
+    const uint64_t *table = move_tables[dir];
+    return (table[r0] << 0) ^ (table[r1] << 16) ^ (table[r2] << 32) ^ (table[r3] << 48);
+#endif
+}
 
-        row_left_table[row] = row ^ result;
-        row_right_table[rev_row] = rev_row ^ rev_result;
-        col_up_table[row] = unpack_col(row) ^ unpack_col(result);
-        col_down_table[rev_row] = unpack_col(rev_row) ^ unpack_col(rev_result);
-    }
+// 棋盘各列向UP/DOWN移动的异或差，t为棋盘的转置
+static inline uint64_t cols_delta(int dir, uint64_t t) {
+#if GAME2048_COMPACT_MOVES
+    // 转置棋盘上的行移动差，转置回来就是原棋盘上的列移动差
+    return transpose(rows_delta(dir == UP ? LEFT : RIGHT, t));
+#else
+    const uint64_t *table = move_tables[dir];
+    return (table[(t >> 0) & ROW_MASK] << 0) ^ (table[(t >> 16) & ROW_MASK] << 4) ^
+           (table[(t >> 32) & ROW_MASK] << 8) ^ (table[(t >> 48) & ROW_MASK] << 12);
+#endif
 }
 
 // 移动执行函数
 uint64_t execute_move_0(uint64_t board) {
-    uint64_t ret = board;
-    uint64_t t = transpose(board);
-    ret ^= (col_up_table[(t >> 0) & ROW_MASK] << 0);
-    ret ^= (col_up_table[(t >> 16) & ROW_MASK] << 4);
-    ret ^= (col_up_table[(t >> 32) & ROW_MASK] << 8);
-    ret ^= (col_up_table[(t >> 48) & ROW_MASK] << 12);
-    return ret;
+    return board ^ cols_delta(UP, transpose(board));
 }
 
 uint64_t execute_move_1(uint64_t board) {
-    uint64_t ret = board;
-    uint64_t t = transpose(board);
-    ret ^= (col_down_table[(t >> 0) & ROW_MASK] << 0);
-    ret ^= (col_down_table[(t >> 16) & ROW_MASK] << 4);
-    ret ^= (col_down_table[(t >> 32) & ROW_MASK] << 8);
-    ret ^= (col_down_table[(t >> 48) & ROW_MASK] << 12);
-    return ret;
+    return board ^ cols_delta(DOWN, transpose(board));
 }
 
 uint64_t execute_move_2(uint64_t board) {
-    uint64_t ret = board;
-    ret ^= (row_left_table[(board >> 0) & ROW_MASK] << 0);
-    ret ^= (row_left_table[(board >> 16) & ROW_MASK] << 16);
-    ret ^= (row_left_table[(board >> 32) & ROW_MASK] << 32);
-    ret ^= (row_left_table[(board >> 48) & ROW_MASK] << 48);
-    return ret;
+    return board ^ rows_delta(LEFT, board);
 }
 
 uint64_t execute_move_3(uint64_t board) {
-    uint64_t ret = board;
-    ret ^= (row_right_table[(board >> 0) & ROW_MASK] << 0);
-    ret ^= (row_right_table[(board >> 16) & ROW_MASK] << 16);
-    ret ^= (row_right_table[(board >> 32) & ROW_MASK] << 32);
-    ret ^= (row_right_table[(board >> 48) & ROW_MASK] << 48);
-    return ret;
+    return board ^ rows_delta(RIGHT, board);
 }
 
 uint64_t execute_move(int move, uint64_t board) {
@@ -277,20 +417,140 @@ uint64_t execute_move(int move, uint64_t board) {
     return board; // 无效移动
 }
 
-double score_helper(uint64_t board, double *table) {
-    return table[(board >>  0) & ROW_MASK] +
-           table[(board >> 16) & ROW_MASK] +
-           table[(board >> 32) & ROW_MASK] +
-           table[(board >> 48) & ROW_MASK];
+// 双棋盘走子：搜索中同时保存棋盘b及其转置t，移动后两者都直接由查表更新。
+// UP/DOWN表项正是LEFT/RIGHT表项的列展开（即其转置形式），所以水平移动时
+// 用b的四行查LEFT/RIGHT表得到b的异或差、查UP/DOWN表得到t的异或差；
+// 竖直移动相当于对t做水平移动，两者角色互换。任何方向都不需要转置棋盘；
+// 紧凑走子表没有列展开形式，改为把行差转置一次
+static inline void execute_move_dual(int move, uint64_t b, uint64_t t, uint64_t *nb, uint64_t *nt) {
+    bool vertical = (move == UP || move == DOWN);
+    bool toward_low = (move == LEFT || move == UP);
+    uint64_t src = vertical ? t : b;
+
+    uint64_t drow = rows_delta(toward_low ? LEFT : RIGHT, src);
+#if GAME2048_COMPACT_MOVES
+    uint64_t dcol = transpose(drow);
+#else
+    uint64_t dcol = cols_delta(toward_low ? UP : DOWN, src);
+#endif
+
+    if (vertical) {
+        *nb = b ^ dcol;
+        *nt = t ^ drow;
+    } else {
+        *nb = b ^ drow;
+        *nt = t ^ dcol;
+    }
+}
+
+// 批量走子：out[4*i + 方向]为boards[i]向该方向移动后的棋盘
+static void execute_moves_batch_scalar(const uint64_t* boards, int count, uint64_t* out) {
+    for (int i = 0; i < count; i++) {
+        out[4 * i + UP] = execute_move_0(boards[i]);
+        out[4 * i + DOWN] = execute_move_1(boards[i]);
+        out[4 * i + LEFT] = execute_move_2(boards[i]);
+        out[4 * i + RIGHT] = execute_move_3(boards[i]);
+    }
+}
+
+#ifdef HAVE_AVX2_MOVES
+#if GAME2048_COMPACT_MOVES
+// 16位行差在UP/DOWN通道上展开为列形式：nibble k移到位16k
+__attribute__((target("avx2")))
+static inline __m256i unpack_col_lanes(__m256i d) {
+    __m256i col = _mm256_and_si256(d, _mm256_set1_epi64x(0xF));
+    col = _mm256_or_si256(col, _mm256_slli_epi64(_mm256_and_si256(d, _mm256_set1_epi64x(0xF0)), 12));
+    col = _mm256_or_si256(col, _mm256_slli_epi64(_mm256_and_si256(d, _mm256_set1_epi64x(0xF00)), 24));
+    col = _mm256_or_si256(col, _mm256_slli_epi64(_mm256_and_si256(d, _mm256_set1_epi64x(0xF000)), 36));
+    return _mm256_blend_epi32(col, d, 0xF0);    // LEFT/RIGHT通道保留行形式
+}
+#endif
+
+// 每个棋盘一个向量，四个64位通道分别对应UP/DOWN/LEFT/RIGHT：
+// 每一行一次gather取回四个方向的异或差，列方向按4k位移、行方向按16k位移
+__attribute__((target("avx2")))
+static void execute_moves_batch_avx2(const uint64_t* boards, int count, uint64_t* out) {
+#if GAME2048_COMPACT_MOVES
+    // 按2字节步长gather 8字节，低16位即表项
+    const long long* base = (const long long*)&row_deltas[0][0];
+    const __m256i table_offset = _mm256_setr_epi64x(0, ROW_DELTA_STRIDE, 0, ROW_DELTA_STRIDE);
+    const __m256i delta_mask = _mm256_set1_epi64x(ROW_MASK);
+#else
+    const long long* base = (const long long*)&move_tables[0][0];
+    const __m256i table_offset = _mm256_setr_epi64x((long long)UP * ROW_MAX, (long long)DOWN * ROW_MAX,
+                                                    (long long)LEFT * ROW_MAX, (long long)RIGHT * ROW_MAX);
+#endif
+    const __m256i row_mask = _mm256_set1_epi64x(ROW_MASK);
+    const __m256i shift_step = _mm256_setr_epi64x(4, 4, 16, 16);
+
+    for (int i = 0; i < count; i++) {
+        uint64_t board = boards[i];
+        uint64_t t = transpose(board);
+        __m256i src = _mm256_setr_epi64x((long long)t, (long long)t, (long long)board, (long long)board);
+        __m256i ret = _mm256_set1_epi64x((long long)board);
+        __m256i shift = _mm256_setzero_si256();
+
+        for (int k = 0; k < 4; k++) {
+            __m256i index = _mm256_add_epi64(_mm256_and_si256(src, row_mask), table_offset);
+#if GAME2048_COMPACT_MOVES
+            __m256i delta = _mm256_i64gather_epi64(base, index, 2);
+            delta = unpack_col_lanes(_mm256_and_si256(delta, delta_mask));
+#else
+            __m256i delta = _mm256_i64gather_epi64(base, index, 8);
+#endif
+            ret = _mm256_xor_si256(ret, _mm256_sllv_epi64(delta, shift));
+            src = _mm256_srli_epi64(src, 16);
+            shift = _mm256_add_epi64(shift, shift_step);
+        }
+
+        _mm256_storeu_si256((__m256i*)(out + 4 * i), ret);
+    }
+}
+#endif
+
+static void (*execute_moves_impl)(const uint64_t*, int, uint64_t*) = execute_moves_batch_scalar;
+
+// 供一次处理大量棋盘的调用方使用。搜索的走子节点每次只有一个棋盘，
+// 实测gather的延迟使其比四次标量查表略慢，因此搜索仍逐方向调用execute_move
+void execute_moves_batch(const uint64_t* boards, int count, uint64_t* out) {
+    execute_moves_impl(boards, count, out);
+}
+
+// 选择批量走子的实现，返回是否实际启用了SIMD（CPU不支持时退回标量）
+bool execute_moves_use_simd(bool enable) {
+    execute_moves_impl = execute_moves_batch_scalar;
+#ifdef HAVE_AVX2_MOVES
+    if (enable && __builtin_cpu_supports("avx2")) {
+        execute_moves_impl = execute_moves_batch_avx2;
+        return true;
+    }
+#else
+    (void)enable;
+#endif
+    return false;
 }
 
 double score_heur_board(uint64_t board) {
     // 评估原始棋盘和转置棋盘的启发式得分
-    return score_helper(board, heur_score_table) + score_helper(transpose(board), heur_score_table);
+    return heuristic_rows_score(heur_score_table, board) + heuristic_rows_score(heur_score_table, transpose(board));
+}
+
+double heuristic_table_score(const HeuristicTable* table, uint64_t board) {
+    const heur_t* values = table ? table->values : heur_score_table;
+    return heuristic_rows_score(values, board) + heuristic_rows_score(values, transpose(board));
+}
+
+// 搜索中已知转置时的启发式评分，使用本次搜索的启发式表
+static inline double score_heur_dual(const EvalState *state, uint64_t board, uint64_t board_t) {
+    const heur_t* table = (const heur_t*)state->heur_table;
+    return heuristic_rows_score(table, board) + heuristic_rows_score(table, board_t);
 }
 
 double score_board(uint64_t board) {
-    return score_helper(board, score_table);
+    return (double)score_table[(board >>  0) & ROW_MASK] +
+           score_table[(board >> 16) & ROW_MASK] +
+           score_table[(board >> 32) & ROW_MASK] +
+           score_table[(board >> 48) & ROW_MASK];
 }
 
 uint64_t transpose(uint64_t x) {
@@ -315,33 +575,222 @@ int count_empty(uint64_t x) {
     return x & 0xf;
 }
 
-double score_tilechoose_node(EvalState *state, uint64_t board, double cprob) {
+// 机会节点的展开结果：子棋盘按 空位×砖块 的顺序排列
+typedef struct {
+    uint64_t child[16 * 3];     // 放置新砖块后的棋盘
+    uint64_t child_t[16 * 3];   // 对应的转置棋盘
+    double tile_prob[3];        // 2、4、8砖块的概率权重
+    double total_prob;          // 所考虑砖块的概率之和
+    int num_tiles;              // 每个空位考虑的砖块种类数
+    int num_positions;          // 实际展开的空位数
+    int position[16];           // 展开的空位，pos = 4*行+列
+    double weight[16];          // 各展开空位代表的空位数（对称合并时大于1）
+    double total_weight;        // 权重之和，合并得分时的分母
+} ChanceExpansion;
+
+// 左右镜像：每行内四个格子倒序
+static inline uint64_t mirror_rows(uint64_t x) {
+    return ((x & 0x000F000F000F000FULL) << 12) | ((x & 0x00F000F000F000F0ULL) << 4) |
+           ((x >> 4) & 0x00F000F000F000F0ULL) | ((x >> 12) & 0x000F000F000F000FULL);
+}
+
+// 上下镜像：四行倒序
+static inline uint64_t mirror_cols(uint64_t x) {
+    return (x << 48) | ((x & 0xFFFF0000ULL) << 16) | ((x >> 16) & 0xFFFF0000ULL) | (x >> 48);
+}
+
+// 棋盘在二面体群8个变换（旋转、镜像）下的最小像，作为转置表的键。
+// 启发式对每行每列的正反方向对称，max节点取四个方向的最大值，精确展开时
+// 8个等价棋盘的期望值相同，可以共用一个表项
+static inline uint64_t canonical_board(uint64_t board, uint64_t board_t) {
+    uint64_t v = mirror_cols(board);
+    uint64_t tv = mirror_cols(board_t);
+    uint64_t key = board;
+    uint64_t images[7] = {
+        mirror_rows(board), v, mirror_rows(v),
+        board_t, mirror_rows(board_t), tv, mirror_rows(tv)
+    };
+    for (int k = 0; k < 7; k++) {
+        if (images[k] < key) key = images[k];
+    }
+    return key;
+}
+
+// 转置表的键：开启对称合并时为规范形式，否则为棋盘本身
+static inline uint64_t table_key(const EvalState *state, uint64_t board, uint64_t board_t) {
+    return state->tt_symmetry ? canonical_board(board, board_t) : board;
+}
+
+// 机会节点的前置处理：深度限制、概率剪枝、转置表命中或无空位时直接得出结果
+static bool resolve_chance_node(EvalState *state, uint64_t board, uint64_t board_t, double cprob, double *result) {
+    state->stats.chance_nodes[state->curdepth]++;
+
     // 深度限制和概率剪枝
     if (cprob < CPROB_THRESH_BASE || state->curdepth >= state->depth_limit) {
-        state->maxdepth = max(state->maxdepth, state->curdepth);
-        return score_heur_board(board);
+        if (state->curdepth >= state->depth_limit) {
+            state->stats.depth_cutoffs++;
+        } else {
+            state->stats.cprob_prunes++;
+        }
+        state->stats.maxdepth = max(state->stats.maxdepth, state->curdepth);
+        state->stats.heuristic_evals++;
+        *result = score_heur_dual(state, board, board_t);
+        return true;
     }
 
-    // 使用转置表缓存结果
+    // 使用转置表缓存结果：表中记录的是剩余搜索深度，不浅于当前所需才可复用，
+    // 因此迭代加深时上一轮较浅层的结果可被下一轮较深层直接使用
     if (state->curdepth < CACHE_DEPTH_LIMIT) {
-        TransEntry *entry = find_in_table(state->trans_table, board);
-        if (entry != NULL && entry->depth <= state->curdepth) {
-            state->cachehits++;
-            return entry->score;
+        TransEntry entry;
+        state->stats.tt_probes++;
+        if (find_in_table(state->trans_table, table_key(state, board, board_t), &entry) &&
+            entry.depth >= state->depth_limit - state->curdepth) {
+            state->stats.tt_hits++;
+            *result = entry.score;
+            return true;
         }
     }
 
-    // 获取空位数量
+    // 如果没有空位，游戏结束
+    if (count_empty(board) == 0) {
+        *result = SCORE_LOST_PENALTY;
+        return true;
+    }
+
+    return false;
+}
+
+// 原有的步长采样，保留以便与旧版本对比。sample_count只在选中时递增，
+// 空位为7个时步长为1，全部展开；8个及以上时第一个空位就不满足条件，因此一个空位也不展开，节点得分为0
+static void expand_legacy(uint64_t board, ChanceExpansion *exp) {
     int num_empty = count_empty(board);
-    if (num_empty == 0) {
-        return SCORE_LOST_PENALTY;  // 如果没有空位，游戏结束
+
+    // 采样密度策略：更智能地采样
+    int max_samples;
+    if (num_empty <= 6) {
+        // 当空位较少时，考虑全部空位
+        max_samples = num_empty;
+    } else {
+        // 当空位较多时，使用采样
+        max_samples = 6 + (num_empty > 10 ? 2 : 1);
+        if (max_samples > 10) max_samples = 10; // 平衡性能和精度
     }
 
-    // 调整概率
-    cprob /= num_empty;
-    
-    double res = 0.0;
-    
+    // 扫描所有可能的位置
+    int sample_count = 0;
+    for (int pos = 0; pos < 16; pos++) {
+        // 检查位置是否为空
+        if (((board >> (pos * 4)) & 0xF) == 0) {
+            // 计算是否需要采样这个位置
+            if (num_empty <= 6 || (sample_count * max_samples) / num_empty != ((sample_count + 1) * max_samples) / num_empty) {
+                exp->position[sample_count] = pos;
+                exp->weight[sample_count] = 1;
+                sample_count++;
+            }
+        }
+    }
+
+    exp->num_positions = sample_count;
+    exp->total_weight = sample_count;
+}
+
+// 棋盘二面体群的8个变换中使棋盘不变的那些，对空位 (行,列) 的作用。
+// 返回使棋盘不变的非恒等变换个数，maps[k][pos]为第k个变换把pos映射到的位置
+static int board_symmetries(uint64_t board, uint64_t board_t, uint8_t maps[7][16]) {
+    uint64_t h = mirror_rows(board);
+    uint64_t v = mirror_cols(board);
+    uint64_t hv = mirror_rows(v);
+    uint64_t th = mirror_rows(board_t);
+    uint64_t tv = mirror_cols(board_t);
+    uint64_t thv = mirror_rows(tv);
+    uint64_t images[7] = { h, v, hv, board_t, thv, th, tv };
+
+    int count = 0;
+    for (int k = 0; k < 7; k++) {
+        if (images[k] != board) continue;
+        for (int pos = 0; pos < 16; pos++) {
+            int r = pos >> 2, c = pos & 3;
+            int nr, nc;
+            switch (k) {
+                case 0: nr = r; nc = 3 - c; break;          // 左右镜像
+                case 1: nr = 3 - r; nc = c; break;          // 上下镜像
+                case 2: nr = 3 - r; nc = 3 - c; break;      // 旋转180度
+                case 3: nr = c; nc = r; break;              // 转置
+                case 4: nr = 3 - c; nc = 3 - r; break;      // 反对角线翻转
+                case 5: nr = c; nc = 3 - r; break;          // 转置后左右镜像
+                default: nr = 3 - c; nc = r; break;         // 转置后上下镜像
+            }
+            maps[count][pos] = (uint8_t)(nr * 4 + nc);
+        }
+        count++;
+    }
+    return count;
+}
+
+// 枚举全部空位。棋盘对称时，被同一对称变换互相映射的空位得分相同，
+// 只展开编号最小的一个，权重为等价空位的个数
+static void expand_exact(uint64_t board, uint64_t board_t, ChanceExpansion *exp) {
+    uint8_t maps[7][16];
+    int num_syms = board_symmetries(board, board_t, maps);
+    int index_of[16];
+
+    exp->num_positions = 0;
+    exp->total_weight = 0;
+    for (int pos = 0; pos < 16; pos++) {
+        if (((board >> (pos * 4)) & 0xF) != 0) continue;
+
+        int canonical = pos;
+        for (int k = 0; k < num_syms; k++) {
+            if (maps[k][pos] < canonical) canonical = maps[k][pos];
+        }
+        if (canonical == pos) {
+            index_of[pos] = exp->num_positions;
+            exp->position[exp->num_positions] = pos;
+            exp->weight[exp->num_positions] = 1;
+            exp->num_positions++;
+        } else {
+            exp->weight[index_of[canonical]] += 1;
+        }
+        exp->total_weight += 1;
+    }
+}
+
+// 空位不超过max_samples时全部展开，否则无放回均匀抽取max_samples个，
+// 每个空位被抽中的概率相同，子节点得分的平均值是全部空位平均值的无偏估计。
+// 随机数由棋盘派生，同一棋盘总抽到同一组空位，与转置表和多线程搜索保持一致
+static void expand_stochastic(uint64_t board, int max_samples, ChanceExpansion *exp) {
+    int empty[16];
+    int num_empty = 0;
+    for (int pos = 0; pos < 16; pos++) {
+        if (((board >> (pos * 4)) & 0xF) == 0) empty[num_empty++] = pos;
+    }
+
+    int count = num_empty;
+    if (num_empty > max_samples) {
+        // 部分Fisher-Yates洗牌，随机数由棋盘播种，同一棋盘总是抽到同样的空位
+        Rng rng;
+        rng_seed(&rng, board);
+        for (int i = 0; i < max_samples; i++) {
+            int j = i + (int)rng_below(&rng, (uint32_t)(num_empty - i));
+            int tmp = empty[i];
+            empty[i] = empty[j];
+            empty[j] = tmp;
+        }
+        count = max_samples;
+    }
+
+    for (int i = 0; i < count; i++) {
+        exp->position[i] = empty[i];
+        exp->weight[i] = 1;
+    }
+    exp->num_positions = count;
+    exp->total_weight = count;
+}
+
+// 展开机会节点：确定展开的空位和需要考虑的新砖块
+static void expand_chance_node(uint64_t board, uint64_t board_t, int curdepth, int mode, int max_samples,
+                               ChanceExpansion *exp) {
+
     // 获取当前棋盘最大砖块的幂
     int maxrank = get_max_rank(board);
     
@@ -361,70 +810,176 @@ double score_tilechoose_node(EvalState *state, uint64_t board, double cprob) {
         prob_2 = 0.6;
         prob_4 = 0.3;
     }
+
+    exp->tile_prob[0] = prob_2;
+    exp->tile_prob[1] = prob_4;
+    exp->total_prob = prob_2 + prob_4;
+    exp->num_tiles = 2;
+
+    // 如果最大砖块较大(>=9)且处于浅层，考虑8砖块 (2^3)
+    if (maxrank >= 9 && curdepth < 2) {
+        exp->tile_prob[2] = 0.1;
+        exp->total_prob += exp->tile_prob[2];
+        exp->num_tiles = 3;
+    }
     
-    // 采样密度策略：更智能地采样
-    int max_samples;
-    if (num_empty <= 6) {
-        // 当空位较少时，考虑全部空位
-        max_samples = num_empty;
-    } else {
-        // 当空位较多时，使用采样
-        max_samples = 6 + (num_empty > 10 ? 2 : 1);
-        if (max_samples > 10) max_samples = 10; // 平衡性能和精度
+    switch (mode) {
+        case SAMPLE_EXACT:
+            expand_exact(board, board_t, exp);
+            break;
+        case SAMPLE_STOCHASTIC:
+            expand_stochastic(board, max_samples, exp);
+            break;
+        default:
+            expand_legacy(board, exp);
+            break;
     }
 
-    // 扫描所有可能的位置
-    int sample_count = 0;
-    
-    for (int pos = 0; pos < 16; pos++) {
-        // 检查位置是否为空
-        if (((board >> (pos * 4)) & 0xF) == 0) {
-            // 计算是否需要采样这个位置
-            if (num_empty <= 6 || (sample_count * max_samples) / num_empty != ((sample_count + 1) * max_samples) / num_empty) {
-                // 考虑2砖块 (2^1)
-                double score2 = score_move_node(state, board | (1ULL << (pos * 4)), cprob * prob_2);
-                
-                // 考虑4砖块 (2^2)
-                double score4 = score_move_node(state, board | (2ULL << (pos * 4)), cprob * prob_4);
-                
-                // 如果是深度较大(>=3)且最大砖块较大(>=9)，考虑8砖块 (2^3)
-                double total_prob = prob_2 + prob_4;
-                double weighted_score = score2 * prob_2 + score4 * prob_4;
-                
-                if (maxrank >= 9 && state->curdepth < 2) {
-                    // 在符合条件的情况下偶尔考虑8
-                    double prob_8 = 0.1;
-                    double score8 = score_move_node(state, board | (3ULL << (pos * 4)), cprob * prob_8);
-                    total_prob += prob_8;
-                    weighted_score += score8 * prob_8;
-                }
-                
-                // 归一化概率
-                res += weighted_score / total_prob;
-                sample_count++;
-            }
+    // 生成子棋盘：pos = 4*行+列，在转置棋盘中位于 4*列+行
+    int n = 0;
+    for (int p = 0; p < exp->num_positions; p++) {
+        int pos = exp->position[p];
+        int pos_t = ((pos & 3) << 2) | (pos >> 2);
+        for (int t = 0; t < exp->num_tiles; t++) {
+            exp->child_t[n] = board_t | ((uint64_t)(t + 1) << (pos_t * 4));
+            exp->child[n++] = board | ((uint64_t)(t + 1) << (pos * 4));
         }
     }
-    
-    // 规范化结果 - 现在根据实际采样数量来规范化
-    if (sample_count > 0) {
-        res /= sample_count;
+}
+
+// 按概率合并子节点得分，scores与exp->child一一对应
+static double combine_chance_node(const ChanceExpansion *exp, const double *scores) {
+    double res = 0.0;
+
+    for (int p = 0; p < exp->num_positions; p++) {
+        double weighted_score = 0.0;
+        for (int t = 0; t < exp->num_tiles; t++) {
+            weighted_score += scores[p * exp->num_tiles + t] * exp->tile_prob[t];
+        }
+        // 归一化概率，对称合并的空位按其代表的空位数加权
+        res += exp->weight[p] * (weighted_score / exp->total_prob);
+    }
+
+    // 规范化结果 - 根据展开空位代表的空位总数来规范化
+    if (exp->num_positions > 0) {
+        res /= exp->total_weight;
+    }
+
+    return res;
+}
+
+// 并行搜索任务：对一个子节点求值，使用私有的评估状态并共享转置表
+typedef struct {
+    EvalState state;
+    uint64_t board;
+    uint64_t board_t;           // board的转置
+    double cprob;               // 机会子节点的累计概率
+    int move;                   // 根节点任务的移动方向
+    double score;
+} SearchTask;
+
+// 初始化任务的评估状态：继承搜索参数，统计计数清零
+static void init_task_state(SearchTask *task, const EvalState *parent) {
+    task->state = *parent;
+    memset(&task->state.stats, 0, sizeof(task->state.stats));
+}
+
+// 把任务的统计合并回父节点
+static void merge_task_stats(EvalState *parent, const SearchTask *tasks, int count) {
+    for (int i = 0; i < count; i++) {
+        search_stats_merge(&parent->stats, &tasks[i].state.stats);
+    }
+}
+
+static void run_child_task(void* arg) {
+    SearchTask* task = (SearchTask*)arg;
+    task->score = score_move_node(&task->state, task->board, task->board_t, task->cprob);
+}
+
+// 把机会节点的所有子节点作为任务并行求值，scores按exp->child的顺序填充。
+// 任务数组（每个任务带一份完整的评估状态）取自当前线程的分配器，不占用线程栈；
+// 分配失败时退回串行求值
+static void score_children_parallel(EvalState *state, const ChanceExpansion *exp, double cprob, double *scores) {
+    int num_children = exp->num_positions * exp->num_tiles;
+    Arena* arena = arena_thread_local();
+    ArenaMark mark = arena ? arena_mark(arena) : (ArenaMark){ NULL, 0 };
+    SearchTask* tasks = arena ? (SearchTask*)arena_alloc(arena, num_children * sizeof(SearchTask),
+                                                         _Alignof(SearchTask)) : NULL;
+    if (!tasks) {
+        for (int i = 0; i < num_children; i++) {
+            scores[i] = score_move_node(state, exp->child[i], exp->child_t[i],
+                                        cprob * exp->tile_prob[i % exp->num_tiles]);
+        }
+        return;
+    }
+
+    for (int i = 0; i < num_children; i++) {
+        init_task_state(&tasks[i], state);
+        tasks[i].board = exp->child[i];
+        tasks[i].board_t = exp->child_t[i];
+        tasks[i].cprob = cprob * exp->tile_prob[i % exp->num_tiles];
+    }
+
+    thread_pool_run(state->pool, run_child_task, tasks, sizeof(SearchTask), num_children);
+
+    for (int i = 0; i < num_children; i++) {
+        scores[i] = tasks[i].score;
+    }
+    merge_task_stats(state, tasks, num_children);
+    arena_release(arena, mark);
+}
+
+double score_tilechoose_node(EvalState *state, uint64_t board, uint64_t board_t, double cprob) {
+    double res;
+    if (search_expired(state)) {
+        return 0;
+    }
+    if (resolve_chance_node(state, board, board_t, cprob, &res)) {
+        return res;
+    }
+
+    // 调整概率
+    cprob /= count_empty(board);
+
+    ChanceExpansion exp;
+    double scores[16 * 3];
+    expand_chance_node(board, board_t, state->curdepth, state->sample_mode, state->max_samples, &exp);
+
+    // 浅层节点的子树作为任务分发，深层节点串行搜索
+    if (state->pool && state->curdepth < state->parallel_depth) {
+        score_children_parallel(state, &exp, cprob, scores);
+    } else {
+        int num_children = exp.num_positions * exp.num_tiles;
+        for (int i = 0; i < num_children; i++) {
+            scores[i] = score_move_node(state, exp.child[i], exp.child_t[i], cprob * exp.tile_prob[i % exp.num_tiles]);
+        }
     }
+
+    res = combine_chance_node(&exp, scores);
     
-    // 缓存结果
-    if (state->curdepth < CACHE_DEPTH_LIMIT) {
-        insert_to_table(state->trans_table, board, state->curdepth, res);
+    // 缓存结果，超时中止的子树结果不完整，不写入
+    if (state->curdepth < CACHE_DEPTH_LIMIT && !search_aborted(state)) {
+        switch (insert_to_table(state->trans_table, table_key(state, board, board_t),
+                                state->depth_limit - state->curdepth, res)) {
+            case TT_INSERT_EMPTY: state->stats.tt_inserts++; break;
+            case TT_INSERT_UPDATE: state->stats.tt_updates++; break;
+            case TT_INSERT_STALE: state->stats.tt_evictions++; break;
+            case TT_INSERT_COLLISION: state->stats.tt_collisions++; break;
+        }
     }
     
     return res;
 }
 
-double score_move_node(EvalState *state, uint64_t board, double cprob) {
+double score_move_node(EvalState *state, uint64_t board, uint64_t board_t, double cprob) {
     if (state->curdepth >= state->depth_limit) {
-        state->maxdepth = max(state->maxdepth, state->curdepth);
-        return score_heur_board(board);
+        state->stats.depth_cutoffs++;
+        state->stats.maxdepth = max(state->stats.maxdepth, state->curdepth);
+        state->stats.heuristic_evals++;
+        return score_heur_dual(state, board, board_t);
     }
 
+    state->stats.move_nodes[state->curdepth]++;
     state->curdepth++;
     double best = 0.0;
     
@@ -436,11 +991,12 @@ double score_move_node(EvalState *state, uint64_t board, double cprob) {
     
     for (int i = 0; i < move_count; i++) {
         int move = move_order[i];
-        uint64_t newboard = execute_move(move, board);
-        state->moves_evaled++;
+        uint64_t newboard, newboard_t;
+        execute_move_dual(move, board, board_t, &newboard, &newboard_t);
+        state->stats.moves_evaled++;
 
         if (board != newboard) {
-            double score = score_tilechoose_node(state, newboard, cprob);
+            double score = score_tilechoose_node(state, newboard, newboard_t, cprob);
             if (score > best) {
                 best = score;
             }
@@ -452,28 +1008,118 @@ double score_move_node(EvalState *state, uint64_t board, double cprob) {
 }
 
 double score_toplevel_move(EvalState *state, uint64_t board, int move) {
-    uint64_t newboard = execute_move(move, board);
+    uint64_t newboard, newboard_t;
+    execute_move_dual(move, board, transpose(board), &newboard, &newboard_t);
     
     if (board == newboard)
         return 0;
         
-    return score_tilechoose_node(state, newboard, 1.0) + 1e-6;
+    return score_tilechoose_node(state, newboard, newboard_t, 1.0) + 1e-6;
 }
 
-int find_best_move(GameState* state, int depth_limit) {
+static void run_root_task(void* arg) {
+    SearchTask* task = (SearchTask*)arg;
+    task->score = score_toplevel_move(&task->state, task->board, task->move);
+}
+
+// 并行评估根节点的所有方向，每个方向一个任务，
+// 其下的浅层机会节点继续在线程池中展开
+static void score_toplevel_moves_parallel(EvalState *state, uint64_t board,
+                                          const int *move_order, double *move_scores) {
+    SearchTask tasks[4];
+
+    for (int i = 0; i < 4; i++) {
+        init_task_state(&tasks[i], state);
+        tasks[i].board = board;
+        tasks[i].move = move_order[i];
+    }
+
+    thread_pool_run(state->pool, run_root_task, tasks, sizeof(SearchTask), 4);
+
+    for (int i = 0; i < 4; i++) {
+        move_scores[i] = tasks[i].score;
+    }
+    merge_task_stats(state, tasks, 4);
+}
+
+// 是否还有能改变棋盘的移动（不打印，供搜索入口使用）
+static bool board_has_move(uint64_t board) {
+    if (count_empty(board) > 0) return true;
+    for (int move = 0; move < 4; move++) {
+        if (execute_move(move, board) != board) return true;
+    }
+    return false;
+}
+
+// 一次搜索结束：整体归还调用线程分配器中的搜索内存。并行展开按嵌套顺序归还，
+// 正常情况下这里已经为空，重置保证任何路径下都不会跨搜索累积。
+// 工作线程的分配器同样按嵌套顺序归还；串行搜索不使用分配器
+static void release_search_memory(SearchContext* ctx) {
+    if (ctx->pool) {
+        Arena* arena = arena_thread_local();
+        if (arena) arena_reset(arena);
+    }
+}
+
+// 以固定深度评估根节点的四个方向，move_scores与move_order一一对应。
+// deadline非NULL时可能超时中止，此时返回false，move_scores不可用
+static bool search_root(SearchContext* ctx, EvalState* eval_state, uint64_t board, int depth_limit,
+                        SearchDeadline* deadline, const int* move_order, double* move_scores) {
+    eval_state->trans_table = ctx->trans_table;
+    eval_state->curdepth = 0;
+    memset(&eval_state->stats, 0, sizeof(eval_state->stats));
+    eval_state->depth_limit = depth_limit;
+    eval_state->pool = ctx->pool;
+    eval_state->parallel_depth = ctx->parallel_depth;
+    eval_state->deadline = deadline;
+    eval_state->poll_countdown = DEADLINE_POLL_INTERVAL;
+    eval_state->heur_table = ctx->heuristic ? ctx->heuristic->values : heur_score_table;
+    eval_state->sample_mode = ctx->sample_mode;
+    eval_state->max_samples = ctx->max_samples;
+    eval_state->tt_symmetry = ctx->tt_symmetry;
+
+    if (ctx->pool) {
+        score_toplevel_moves_parallel(eval_state, board, move_order, move_scores);
+    } else {
+        for (int i = 0; i < 4; i++) {
+            move_scores[i] = score_toplevel_move(eval_state, board, move_order[i]);
+        }
+    }
+
+    return !search_aborted(eval_state);
+}
+
+// 填充搜索报告的公共部分，move_scores按move_order排列，报告中按方向编号存放
+static void init_report(SearchReport* report, uint64_t board, int depth_limit, int budget_ms,
+                        const int* move_order, const double* move_scores, int best_move, double best_score) {
+    memset(report, 0, sizeof(*report));
+    report->board = board;
+    report->depth_limit = depth_limit;
+    report->budget_ms = budget_ms;
+    for (int i = 0; i < 4; i++) {
+        int move = move_order[i] & 3;
+        report->move_legal[move] = execute_move(move, board) != board;
+        report->move_scores[move] = report->move_legal[move] ? move_scores[i] : 0;
+    }
+    report->best_move = best_move;
+    report->best_score = best_score;
+}
+
+int find_best_move_ctx(SearchContext* ctx, GameState* state, int depth_limit) {
     uint64_t board = state->board;
     EvalState eval_state;
     double best_score = 0;
     int best_move = -1;
     
-    if (is_game_over(state)) {
+    if (!board_has_move(board)) {
+        memset(&ctx->last_stats, 0, sizeof(ctx->last_stats));
         return -1;
     }
     
     // 限制最大搜索深度为15
-    if (depth_limit > 15) {
-        depth_limit = 15;
-        printf("搜索深度已限制为15\n");
+    if (depth_limit > MAX_SEARCH_DEPTH) {
+        depth_limit = MAX_SEARCH_DEPTH;
+        LOG_DEBUG("搜索深度已限制为15\n");
     }
     
     // 根据棋盘空位和最大砖块动态调整深度
@@ -502,44 +1148,175 @@ int find_best_move(GameState* state, int depth_limit) {
         depth_limit = min(depth_limit + 1, 7);
     }
     
-    // 创建适当大小的转置表
-    eval_state.trans_table = create_trans_table(TRANSTABLE_SIZE); 
-    eval_state.maxdepth = 0;
-    eval_state.curdepth = 0;
-    eval_state.cachehits = 0;
-    eval_state.moves_evaled = 0;
-    eval_state.depth_limit = depth_limit;
+    // 复用上下文中的转置表，推进代数使上一步的条目失效
+    double start = now_ms();
+    trans_table_new_generation(ctx->trans_table);
+
+    // 不限时，只用于响应取消
+    SearchDeadline deadline;
+    deadline.deadline_ms = INFINITY;
+    deadline.cancel = &ctx->cancel;
+    atomic_init(&deadline.expired, search_cancelled(ctx));
 
-    printf("AI思考中...(深度: %d, 空位: %d, 全方向搜索, 高密度采样)\n", depth_limit, empty_count);
+    LOG_DEBUG("AI思考中...(深度: %d, 空位: %d, 全方向搜索, 高密度采样)\n", depth_limit, empty_count);
     
     // 评估所有四个方向
     int move_order[4] = {LEFT, UP, RIGHT, DOWN};
+    double move_scores[4];
+    if (!search_root(ctx, &eval_state, board, depth_limit, &deadline, move_order, move_scores)) {
+        // 被取消：结果不完整，不回调
+        eval_state.stats.elapsed_ms = now_ms() - start;
+        ctx->last_stats = eval_state.stats;
+        release_search_memory(ctx);
+        LOG_DEBUG("搜索已取消\n");
+        return -1;
+    }
     
     for (int i = 0; i < 4; i++) {
         int move = move_order[i];
         uint64_t newboard = execute_move(move, board);
         if (board != newboard) {
-            double score = score_toplevel_move(&eval_state, board, move);
+            double score = move_scores[i];
             if (score > best_score) {
                 best_score = score;
                 best_move = move;
             }
             
-            printf("分析%s方向...得分: %.0f\n", 
+            LOG_DEBUG("分析%s方向...得分: %.0f\n", 
                 move == UP ? "UP" : (move == DOWN ? "DOWN" : (move == LEFT ? "LEFT" : "RIGHT")), 
                 score);
         }
     }
 
-    printf("AI评估了%d个位置，缓存命中%d次，最大深度%d\n", 
-           eval_state.moves_evaled, eval_state.cachehits, eval_state.maxdepth);
-    printf("最佳移动方向: %d, 得分: %.0f\n", best_move, best_score);
+    eval_state.stats.elapsed_ms = now_ms() - start;
+    ctx->last_stats = eval_state.stats;
+    release_search_memory(ctx);
+
+    LOG_DEBUG("AI评估了%llu个位置，缓存命中%llu次，最大深度%d\n",
+              (unsigned long long)eval_state.stats.moves_evaled,
+              (unsigned long long)eval_state.stats.tt_hits, eval_state.stats.maxdepth);
+    LOG_DEBUG("最佳移动方向: %d, 得分: %.0f\n", best_move, best_score);
+
+    if (ctx->report) {
+        SearchReport report;
+        init_report(&report, board, depth_limit, 0, move_order, move_scores, best_move, best_score);
+        report.completed_depth = depth_limit;
+        report.stats = eval_state.stats;
+        ctx->report(&report, ctx->report_user);
+    }
+
+    return best_move;
+}
+
+// 限时搜索：从深度1开始迭代加深，同一步的各轮共用一代转置表，
+// 超过budget_ms时中止当前一轮，返回最后一轮完整结果中的最佳方向。
+// 深度1不受时限约束（只响应取消），保证总有可用的结果；预计下一轮会超时则提前结束。
+// 被search_context_set_cancel取消时返回-1
+int find_best_move_timed(SearchContext* ctx, GameState* state, int budget_ms) {
+    uint64_t board = state->board;
+    int move_order[4] = {LEFT, UP, RIGHT, DOWN};
+    double best_score = 0;
+    int best_move = -1;
+    int completed_depth = 0;
+    SearchStats stats;
+    double best_scores[4] = {0, 0, 0, 0};
+
+    memset(&stats, 0, sizeof(stats));
+    if (!board_has_move(board)) {
+        ctx->last_stats = stats;
+        return -1;
+    }
+
+    double start = now_ms();
+    SearchDeadline deadline;
+    deadline.deadline_ms = start + budget_ms;
+    deadline.cancel = &ctx->cancel;
+    atomic_init(&deadline.expired, search_cancelled(ctx));
+    SearchDeadline first_deadline;
+    first_deadline.deadline_ms = INFINITY;
+    first_deadline.cancel = &ctx->cancel;
+    atomic_init(&first_deadline.expired, search_cancelled(ctx));
+
+    trans_table_new_generation(ctx->trans_table);
+
+    double last_iter_ms = 0;
+    double prev_iter_ms = 0;
+    for (int depth = 1; depth <= MAX_SEARCH_DEPTH; depth++) {
+        EvalState eval_state;
+        double move_scores[4];
+        double iter_start = now_ms();
+
+        bool completed = search_root(ctx, &eval_state, board, depth,
+                                     depth == 1 ? &first_deadline : &deadline, move_order, move_scores);
+        search_stats_merge(&stats, &eval_state.stats);
+        if (!completed) {
+            break;
+        }
+        memcpy(best_scores, move_scores, sizeof(best_scores));
+
+        best_score = 0;
+        best_move = -1;
+        for (int i = 0; i < 4; i++) {
+            if (execute_move(move_order[i], board) != board && move_scores[i] > best_score) {
+                best_score = move_scores[i];
+                best_move = move_order[i];
+            }
+        }
+        completed_depth = depth;
+
+        // 没有叶子到达深度限制（全部被概率剪枝或游戏结束），再加深结果也不会变
+        if (eval_state.stats.maxdepth < depth) {
+            break;
+        }
+
+        // 按最近两轮的用时比例估计下一轮用时，至少翻倍
+        prev_iter_ms = last_iter_ms;
+        last_iter_ms = now_ms() - iter_start;
+        double growth = prev_iter_ms > 0.1 ? last_iter_ms / prev_iter_ms : 4.0;
+        if (growth < 2.0) growth = 2.0;
+        if (now_ms() - start + last_iter_ms * growth > budget_ms) {
+            break;
+        }
+    }
+
+    stats.elapsed_ms = now_ms() - start;
+    ctx->last_stats = stats;
+    release_search_memory(ctx);
+    if (search_cancelled(ctx)) {
+        LOG_DEBUG("限时搜索已取消\n");
+        return -1;
+    }
+    LOG_DEBUG("限时搜索完成深度%d，用时%.1fms/%dms，评估了%llu个位置，缓存命中%llu次\n",
+              completed_depth, stats.elapsed_ms, budget_ms, (unsigned long long)stats.moves_evaled,
+              (unsigned long long)stats.tt_hits);
+    LOG_DEBUG("最佳移动方向: %d, 得分: %.0f\n", best_move, best_score);
+
+    if (ctx->report) {
+        SearchReport report;
+        init_report(&report, board, completed_depth, budget_ms, move_order, best_scores, best_move, best_score);
+        report.completed_depth = completed_depth;
+        report.stats = stats;
+        ctx->report(&report, ctx->report_user);
+    }
 
-    // 清理转置表释放内存
-    free_trans_table(eval_state.trans_table);
     return best_move;
 }
 
+// 使用进程内默认搜索上下文（非线程安全，供单线程前端使用）
+int find_best_move(GameState* state, int depth_limit) {
+    static SearchContext* default_ctx = NULL;
+
+    if (!default_ctx) {
+        default_ctx = search_context_create(TRANSTABLE_SIZE);
+        if (!default_ctx) {
+            LOG_ERROR("错误：无法分配转置表\n");
+            return -1;
+        }
+    }
+
+    return find_best_move_ctx(default_ctx, state, depth_limit);
+}
+
 // 检查棋盘上是否存在大于等于指定值的砖块
 bool has_tile_gte(uint64_t board, int value) {
     int max_tile = 0;
@@ -556,97 +1333,81 @@ bool has_tile_gte(uint64_t board, int value) {
             }
         }
     }
-    printf("棋盘最大值: %d\n", max_tile);
+    LOG_DEBUG("棋盘最大值: %d\n", max_tile);
     return false;
 }
 
-// 添加随机砖块
-uint64_t add_random_tile(uint64_t board) {
-    int empty = count_empty(board);
-    if (empty == 0) {
-        printf("棋盘已满，无法添加新砖块\n");
-        return board;
+// 根据棋盘最大砖块选择新砖块的等级，prob为[0,1)内的均匀随机数
+static unsigned choose_tile_rank(int max_rank, double prob) {
+    int max_tile = 1 << max_rank;
+
+    if (max_tile >= 1024) {
+        // 当最大砖块≥1024时: 2(54%), 4(30%), 8(10%), 16(3%), 32(3%)
+        if (prob < 0.54) return 1;
+        if (prob < 0.54 + 0.3) return 2;
+        if (prob < 0.54 + 0.3 + 0.1) return 3;
+        if (prob < 0.54 + 0.3 + 0.1 + 0.03) return 4;
+        return 5;
+    }
+    if (max_tile >= 512) {
+        // 当最大砖块≥512时: 2(57%), 4(30%), 8(10%), 16(3%)
+        if (prob < 0.57) return 1;
+        if (prob < 0.57 + 0.3) return 2;
+        if (prob < 0.57 + 0.3 + 0.1) return 3;
+        return 4;
     }
+    // 默认情况: 2(60%), 4(30%), 8(10%)
+    if (prob < 0.6) return 1;
+    if (prob < 0.6 + 0.3) return 2;
+    return 3;
+}
 
-    printf("添加新砖块，当前空位数: %d\n", empty);
-    int index = rand() % empty;
-    uint64_t tmp = board;
-    
+// 第index个空位（从低位数起）的格子编号，不存在时返回-1
+static int nth_empty_cell(uint64_t board, int index) {
     for (int i = 0; i < 16; i++) {
-        int shift = i * 4;
-        uint64_t mask = (uint64_t)0xfULL << shift;
-        if ((tmp & mask) == 0) {
+        if (((board >> (i * 4)) & 0xf) == 0) {
             if (index == 0) {
-                // 根据概率添加不同的砖块
-                double prob = (double)rand() / RAND_MAX;
-                unsigned tile_value;
-                
-                // 检查棋盘最大值
-                int max_rank = get_max_rank(board);
-                int max_tile = 1 << max_rank;
-                
-                // 根据最大砖块值调整生成概率分布
-                if (max_tile >= 1024) {
-                    // 当最大砖块≥1024时: 2(54%), 4(30%), 8(10%), 16(3%), 32(3%)
-                    if (prob < 0.54) {
-                        tile_value = 1; // 2^1 = 2
-                    } else if (prob < 0.54 + 0.3) {
-                        tile_value = 2; // 2^2 = 4
-                    } else if (prob < 0.54 + 0.3 + 0.1) {
-                        tile_value = 3; // 2^3 = 8
-                    } else if (prob < 0.54 + 0.3 + 0.1 + 0.03) {
-                        tile_value = 4; // 2^4 = 16
-                    } else {
-                        tile_value = 5; // 2^5 = 32
-                    }
-                    printf("使用高级概率分布: 2(54%%), 4(30%%), 8(10%%), 16(3%%), 32(3%%)\n");
-                }
-                else if (max_tile >= 512) {
-                    // 当最大砖块≥512时: 2(57%), 4(30%), 8(10%), 16(3%)
-                    if (prob < 0.57) {
-                        tile_value = 1; // 2^1 = 2
-                    } else if (prob < 0.57 + 0.3) {
-                        tile_value = 2; // 2^2 = 4
-                    } else if (prob < 0.57 + 0.3 + 0.1) {
-                        tile_value = 3; // 2^3 = 8
-                    } else {
-                        tile_value = 4; // 2^4 = 16
-                    }
-                    printf("使用中级概率分布: 2(57%%), 4(30%%), 8(10%%), 16(3%%)\n");
-                }
-                else {
-                    // 默认情况: 2(60%), 4(30%), 8(10%)
-                    if (prob < 0.6) {
-                        tile_value = 1; // 2^1 = 2
-                    } else if (prob < 0.6 + 0.3) {
-                        tile_value = 2; // 2^2 = 4
-                    } else {
-                        tile_value = 3; // 2^3 = 8
-                    }
-                    printf("使用基础概率分布: 2(60%%), 4(30%%), 8(10%%)\n");
-                }
-                
-                printf("在位置 %d 添加砖块，值: %u (2^%u)\n", i, 1<<tile_value, tile_value);
-                return board | ((uint64_t)tile_value << shift);
+                return i;
             }
             index--;
         }
     }
-    
-    printf("错误：未能添加新砖块\n");
-    return board;
+    return -1;
+}
+
+// 添加随机砖块，使用当前线程默认的随机数生成器
+uint64_t add_random_tile(uint64_t board) {
+    uint64_t new_board = add_random_tile_r(board, rng_thread_default());
+    LOG_DEBUG("添加新砖块，空位数: %d，新棋盘: %llu\n",
+              board ? count_empty(board) : 16, (unsigned long long)new_board);
+    return new_board;
+}
+
+// 使用调用方的随机数生成器添加随机砖块，不打印，可在多线程中使用。
+// 空位均匀选取，砖块值的分布随棋盘最大值调整（见choose_tile_rank）
+uint64_t add_random_tile_r(uint64_t board, Rng* rng) {
+    int empty = count_empty(board);
+    if (empty == 0) {
+        // count_empty对空棋盘返回0（16溢出半字节），空棋盘有16个空位
+        if (board != 0) return board;
+        empty = 16;
+    }
+
+    int pos = nth_empty_cell(board, (int)rng_below(rng, (uint32_t)empty));
+    double prob = rng_double(rng);
+    return board | ((uint64_t)choose_tile_rank(get_max_rank(board), prob) << (pos * 4));
 }
 
 // 将棋盘转换为二维网格（用于显示）
 void board_to_grid(uint64_t board, int grid[BOARD_SIZE][BOARD_SIZE]) {
-    printf("转换棋盘到网格，棋盘值: %llu\n", board);
+    LOG_DEBUG("转换棋盘到网格，棋盘值: %llu\n", (unsigned long long)board);
     for (int i = 0; i < BOARD_SIZE; i++) {
         for (int j = 0; j < BOARD_SIZE; j++) {
             int shift = (i * BOARD_SIZE + j) * 4;
             int value = (board >> shift) & 0xf;
             grid[i][j] = value > 0 ? 1 << value : 0;
             if (value > 0) {
-                printf("位置[%d][%d]: 砖块值 = %d (2^%d)\n", i, j, grid[i][j], value);
+                LOG_DEBUG("位置[%d][%d]: 砖块值 = %d (2^%d)\n", i, j, grid[i][j], value);
             }
         }
     }
@@ -673,43 +1434,23 @@ uint64_t grid_to_board(int grid[BOARD_SIZE][BOARD_SIZE]) {
     return board;
 }
 
-// 初始化游戏状态
+// 初始化游戏状态，使用当前线程默认的随机数生成器
 void init_game(GameState* state) {
-    // 重置所有状态
+    init_game_r(state, rng_thread_default());
+}
+
+// 初始化游戏状态：清空棋盘和分数（保留最高分），用rng落下两个初始砖块
+void init_game_r(GameState* state, Rng* rng) {
     state->board = 0;
     state->score = 0;
     state->game_over = false;
     
     // 添加初始的两个砖块
-    state->board = add_random_tile(state->board);
-    printf("添加第一个砖块后的棋盘状态: %llu\n", state->board);
-    state->board = add_random_tile(state->board);
-    printf("添加第二个砖块后的棋盘状态: %llu\n", state->board);
-    
-    // 如果还是空棋盘，强制添加两个砖块
-    if (state->board == 0) {
-        printf("强制添加砖块，因为自动随机添加失败\n");
-        // 在左上角放置一个2
-        state->board |= ((uint64_t)1 << 0);
-        // 在右下角放置一个4
-        state->board |= ((uint64_t)2 << 60);
-        printf("强制添加后的棋盘状态: %llu\n", state->board);
-    }
-    
-    // 检查是否成功初始化
-    int empty_count = count_empty(state->board);
-    printf("游戏初始化完成，棋盘状态: %llu，空白格子数: %d\n", state->board, empty_count);
+    state->board = add_random_tile_r(state->board, rng);
+    state->board = add_random_tile_r(state->board, rng);
     
-    // 显示初始砖块位置
-    int grid[BOARD_SIZE][BOARD_SIZE];
-    board_to_grid(state->board, grid);
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            if (grid[i][j] > 0) {
-                printf("初始砖块位置[%d][%d]值为: %d\n", i, j, grid[i][j]);
-            }
-        }
-    }
+    LOG_DEBUG("游戏初始化完成，棋盘状态: %llu，空白格子数: %d\n",
+              (unsigned long long)state->board, count_empty(state->board));
 }
 
 // 判断游戏是否结束
@@ -717,21 +1458,21 @@ bool is_game_over(GameState* state) {
     // 如果有空位，游戏未结束
     int empty_count = count_empty(state->board);
     if (empty_count > 0) {
-        printf("棋盘还有 %d 个空位，游戏未结束\n", empty_count);
+        LOG_DEBUG("棋盘还有 %d 个空位，游戏未结束\n", empty_count);
         return false;
     }
     
-    printf("棋盘已满，检查是否有可合并的砖块...\n");
+    LOG_DEBUG("棋盘已满，检查是否有可合并的砖块...\n");
     // 检查是否有可能的移动
     for (int move = 0; move < 4; move++) {
         uint64_t new_board = execute_move(move, state->board);
         if (new_board != state->board) {
-            printf("有可合并的砖块，游戏未结束\n");
+            LOG_DEBUG("有可合并的砖块，游戏未结束\n");
             return false;
         }
     }
     
-    printf("没有可合并的砖块，游戏结束\n");
+    LOG_DEBUG("没有可合并的砖块，游戏结束\n");
     return true;
 }
 
@@ -0,0 +1,94 @@
+// game2048_gentables.c - 构建期查表生成器
+//
+// 编译: 根目录CMake自动构建并运行，输出到构建目录的game2048_tables_data.inc，
+//       game2048_core.c以GAME2048_PREBUILT_TABLES=1编译时直接包含它
+// 用法: game2048_gentables <输出文件>
+// 生成器必须以与引擎相同的GAME2048_HEUR_TABLE/GAME2048_COMPACT_MOVES编译，
+// 输出文件开头会检查这一点。
+#include <stdio.h>
+#include <stdlib.h>
+#include "game2048_tables.h"
+
+#define VALUES_PER_LINE 8
+
+static TableRow rows[ROW_MAX];
+
+static void write_heur(FILE* out, heur_t value) {
+#if GAME2048_HEUR_TABLE == 1
+    fprintf(out, "%af", (double)value);     // 十六进制浮点，精确还原
+#elif GAME2048_HEUR_TABLE == 2
+    fprintf(out, "%ld", (long)value);
+#else
+    fprintf(out, "%a", value);
+#endif
+}
+
+// 以逗号分隔、每行VALUES_PER_LINE个值输出一个表，write_value输出第i项
+#define WRITE_TABLE(out, count, write_value) \
+    do { \
+        for (int i = 0; i < (count); i++) { \
+            fputs(i % VALUES_PER_LINE == 0 ? "    " : " ", out); \
+            write_value; \
+            fputs(i % VALUES_PER_LINE == VALUES_PER_LINE - 1 || i == (count) - 1 ? ",\n" : ",", out); \
+        } \
+    } while (0)
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "用法: %s <输出文件>\n", argv[0]);
+        return 1;
+    }
+
+    static const HeuristicConfig config = HEURISTIC_CONFIG_DEFAULT;
+    HeuristicPowers powers;
+    heuristic_powers_init(&config, &powers);
+    for (unsigned row = 0; row < ROW_MAX; row++) {
+        table_row_generate(row, &config, &powers, &rows[row]);
+    }
+
+    FILE* out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "// game2048_tables_data.inc - 由game2048_gentables生成，请勿手工修改\n");
+    fprintf(out, "#if GAME2048_HEUR_TABLE != %d || GAME2048_COMPACT_MOVES != %d\n",
+            GAME2048_HEUR_TABLE, GAME2048_COMPACT_MOVES);
+    fprintf(out, "#error \"game2048_tables_data.inc与当前的表格式不符，请重新生成\"\n");
+    fprintf(out, "#endif\n\n");
+
+    fprintf(out, "static const heur_t heur_score_table[ROW_MAX] = {\n");
+    WRITE_TABLE(out, ROW_MAX, write_heur(out, rows[i].heur));
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const uint32_t score_table[ROW_MAX] = {\n");
+    WRITE_TABLE(out, ROW_MAX, fprintf(out, "%lu", (unsigned long)rows[i].score));
+    fprintf(out, "};\n\n");
+
+#if GAME2048_COMPACT_MOVES
+    // 每个方向末尾的填充项由零初始化
+    static const int sides[2] = { LEFT, RIGHT };
+    fprintf(out, "static const uint16_t row_deltas[2][ROW_DELTA_STRIDE] = {\n");
+    for (int s = 0; s < 2; s++) {
+        fprintf(out, "  {\n");
+        WRITE_TABLE(out, ROW_MAX, fprintf(out, "0x%04x", (unsigned)rows[i].delta[sides[s]]));
+        fprintf(out, "  },\n");
+    }
+    fprintf(out, "};\n");
+#else
+    fprintf(out, "static const uint64_t move_tables[4][ROW_MAX] = {\n");
+    for (int dir = 0; dir < 4; dir++) {
+        fprintf(out, "  {\n");
+        WRITE_TABLE(out, ROW_MAX, fprintf(out, "0x%016llxULL", (unsigned long long)rows[i].delta[dir]));
+        fprintf(out, "  },\n");
+    }
+    fprintf(out, "};\n");
+#endif
+
+    if (fclose(out) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include "game2048.h"
+#include "game2048_async.h"
 #include <sys/stat.h> // 添加文件检查需要的头文件
 
 // 外部函数声明
@@ -98,6 +99,8 @@ GameState history[10];  // 历史记录，用于撤销
 int history_count = 0;
 bool auto_play = false;
 int ai_depth = 5;
+Rng game_rng;                   // 落子的随机数生成器，启动时以时间播种
+AsyncSearch* ai_search = NULL;  // 自动游戏的后台搜索，主循环每帧查询结果
 // 全局状态文本
 char status_text[100] = "使用方向键或WASD控制";
 Uint32 status_time = 0;
@@ -308,6 +311,10 @@ bool init_sdl() {
 
 // 清理资源
 void cleanup() {
+    // 先停止后台搜索
+    async_search_destroy(ai_search);
+    ai_search = NULL;
+
     // 释放图片资源
     free_tile_images();
     
@@ -619,6 +626,55 @@ void render_game() {
     SDL_RenderPresent(renderer);
 }
 
+// 执行AI选择的移动并落下新砖块，移动前的状态存入撤销记录
+static void apply_ai_move(int direction) {
+    GameState next = game_state;
+    bool moved = false;
+    switch (direction) {
+        case UP: moved = move_up(&next); break;
+        case DOWN: moved = move_down(&next); break;
+        case LEFT: moved = move_left(&next); break;
+        case RIGHT: moved = move_right(&next); break;
+    }
+    if (!moved) return;
+
+    next.board = add_random_tile_r(next.board, &game_rng);
+    next.game_over = is_game_over(&next);
+    save_state();
+    game_state = next;
+}
+
+// AI自动游戏：搜索在后台线程中进行，这里每帧只查询结果，不阻塞渲染。
+// 棋盘在搜索期间被改变（撤销、新游戏、手动移动）时取代或丢弃旧的搜索，重新搜索当前棋盘
+static void update_auto_play() {
+    if (!ai_search) return;
+
+    if (!auto_play || custom_mode || is_game_over(&game_state)) {
+        async_search_cancel(ai_search);
+        return;
+    }
+
+    static uint64_t searching_board = 0;    // 最近一次提交搜索的棋盘
+    int move = -1;
+    uint64_t board = 0;
+    switch (async_search_poll(ai_search, &move, &board)) {
+        case ASYNC_SEARCH_RUNNING:
+            if (searching_board == game_state.board) return;
+            break;              // 棋盘已改变，取代正在进行的搜索
+        case ASYNC_SEARCH_DONE:
+            if (board == game_state.board && move >= 0) {
+                apply_ai_move(move);
+            }
+            break;
+        default:
+            break;
+    }
+    if (!is_game_over(&game_state)) {
+        searching_board = game_state.board;
+        async_search_start(ai_search, searching_board, ai_depth, 0, NULL, NULL);
+    }
+}
+
 // 游戏主循环
 void game_loop() {
     SDL_Event event;
@@ -655,10 +711,8 @@ void game_loop() {
             }
         }
         
-        // 如果AI自动游戏模式开启，立即移动（不在自定义模式下且游戏未结束）
-        if (auto_play && !is_game_over(&game_state) && !custom_mode) {
-            auto_play_move();
-        }
+        // AI自动游戏模式下查询后台搜索，有结果时移动（不在自定义模式下且游戏未结束）
+        update_auto_play();
         
         // 渲染游戏
         render_game();
@@ -677,7 +731,12 @@ int start_game() {
     // 初始化游戏表格
     init_tables();
     // 初始化游戏状态
-    init_game(&game_state);
+    init_game_r(&game_state, &game_rng);
+    // 创建后台搜索，失败时不能自动游戏
+    ai_search = async_search_create(TRANSTABLE_SIZE);
+    if (!ai_search) {
+        set_status_text("无法创建AI搜索线程");
+    }
     // 主游戏循环
     game_loop();
     // 清理资源
@@ -688,7 +747,7 @@ int start_game() {
 // 主函数
 int main(int argc, char* argv[]) {
     // 设置随机数种子
-    srand((unsigned int)time(NULL));
+    rng_seed(&game_rng, (uint64_t)time(NULL));
     return start_game();
 }
 
@@ -0,0 +1,169 @@
+// game2048_heuristic.c - 运行时可配置的启发式权重
+//
+// 配置文件为纯文本，每行一项"名称 = 值"，例如：
+//     # 更看重空位
+//     empty_weight = 350
+//     sum_power = 3.25
+// 名称即HeuristicConfig的字段名，未出现的权重保持原值。
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+#include "game2048_heuristic.h"
+#include "game2048_tables.h"
+#include "game2048_log.h"
+
+#define CONFIG_LINE_MAX 256
+
+static const struct {
+    const char* name;
+    size_t offset;
+} config_fields[] = {
+    { "lost_penalty", offsetof(HeuristicConfig, lost_penalty) },
+    { "monotonicity_power", offsetof(HeuristicConfig, monotonicity_power) },
+    { "monotonicity_weight", offsetof(HeuristicConfig, monotonicity_weight) },
+    { "sum_power", offsetof(HeuristicConfig, sum_power) },
+    { "sum_weight", offsetof(HeuristicConfig, sum_weight) },
+    { "merges_weight", offsetof(HeuristicConfig, merges_weight) },
+    { "empty_weight", offsetof(HeuristicConfig, empty_weight) },
+};
+
+#define NUM_CONFIG_FIELDS ((int)(sizeof(config_fields) / sizeof(config_fields[0])))
+
+void heuristic_config_init(HeuristicConfig* config) {
+    static const HeuristicConfig defaults = HEURISTIC_CONFIG_DEFAULT;
+    *config = defaults;
+}
+
+// 权重在结构体中的偏移，名称未知时返回-1
+static long field_offset(const char* name) {
+    for (int i = 0; i < NUM_CONFIG_FIELDS; i++) {
+        if (strcmp(config_fields[i].name, name) == 0) {
+            return (long)config_fields[i].offset;
+        }
+    }
+    return -1;
+}
+
+const char* heuristic_config_name(int index) {
+    return index >= 0 && index < NUM_CONFIG_FIELDS ? config_fields[index].name : NULL;
+}
+
+bool heuristic_config_get(const HeuristicConfig* config, const char* name, double* value) {
+    long offset = field_offset(name);
+    if (offset < 0) return false;
+    *value = *(const double*)((const char*)config + offset);
+    return true;
+}
+
+bool heuristic_config_set(HeuristicConfig* config, const char* name, double value) {
+    long offset = field_offset(name);
+    if (offset < 0) return false;
+    *(double*)((char*)config + offset) = value;
+    return true;
+}
+
+// 去掉首尾空白，返回去掉后的起始位置
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+bool heuristic_config_load(HeuristicConfig* config, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        LOG_ERROR("错误：无法打开启发式配置 %s\n", path);
+        return false;
+    }
+
+    // 先在副本上修改，出错时不影响调用方的配置
+    HeuristicConfig loaded = *config;
+    char line[CONFIG_LINE_MAX];
+    int line_no = 0;
+    bool ok = true;
+
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_no++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        char* text = trim(line);
+        if (*text == '\0') continue;
+
+        char* eq = strchr(text, '=');
+        if (!eq) {
+            LOG_ERROR("错误：%s:%d 缺少'='\n", path, line_no);
+            ok = false;
+            continue;
+        }
+        *eq = '\0';
+        char* name = trim(text);
+        char* value_text = trim(eq + 1);
+
+        char* end;
+        double value = strtod(value_text, &end);
+        if (end == value_text || *end != '\0') {
+            LOG_ERROR("错误：%s:%d 无效的数值 \"%s\"\n", path, line_no, value_text);
+            ok = false;
+        } else if (!heuristic_config_set(&loaded, name, value)) {
+            LOG_ERROR("错误：%s:%d 未知的权重 \"%s\"\n", path, line_no, name);
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    if (ok) {
+        *config = loaded;
+    }
+    return ok;
+}
+
+bool heuristic_config_save(const HeuristicConfig* config, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        LOG_ERROR("错误：无法写入启发式配置 %s\n", path);
+        return false;
+    }
+
+    for (int i = 0; i < NUM_CONFIG_FIELDS; i++) {
+        // %.17g保证读回后数值完全相同
+        fprintf(file, "%s = %.17g\n", config_fields[i].name,
+                *(const double*)((const char*)config + config_fields[i].offset));
+    }
+    return fclose(file) == 0;
+}
+
+HeuristicTable* heuristic_table_create(const HeuristicConfig* config) {
+    HeuristicTable* table = (HeuristicTable*)malloc(sizeof(HeuristicTable));
+    if (!table) return NULL;
+
+    HeuristicPowers powers;
+    heuristic_powers_init(config, &powers);
+    table->config = *config;
+
+    for (unsigned row = 0; row < ROW_MAX; row++) {
+        double value = heuristic_row_value(row, config, &powers);
+#if GAME2048_HEUR_TABLE == 2
+        if (!(value > -HEUR_FIXED_LIMIT && value < HEUR_FIXED_LIMIT)) {
+            LOG_ERROR("错误：启发式得分%g超出定点格式的范围\n", value);
+            free(table);
+            return NULL;
+        }
+#endif
+        table->values[row] = heuristic_store_value(value);
+    }
+
+    return table;
+}
+
+void heuristic_table_destroy(HeuristicTable* table) {
+    free(table);
+}
+
+const HeuristicConfig* heuristic_table_config(const HeuristicTable* table) {
+    return &table->config;
+}
@@ -0,0 +1,56 @@
+// game2048_heuristic.h - 运行时可配置的启发式权重
+//
+// 默认权重即game2048.h中的SCORE_*常量，对应编译进引擎的默认启发式表。
+// 调整权重时用heuristic_table_create按配置生成一张新的启发式表（只重建这一张表，
+// 各等级的幂次预先算好，生成一张表约1ms），再通过search_context_set_heuristic
+// 或BatchConfig.heuristic交给搜索。多张表可以在同一进程中同时使用。
+#ifndef GAME2048_HEURISTIC_H
+#define GAME2048_HEURISTIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 启发式权重，含义同game2048.h中对应的SCORE_*常量
+typedef struct {
+    double lost_penalty;
+    double monotonicity_power;
+    double monotonicity_weight;
+    double sum_power;
+    double sum_weight;
+    double merges_weight;
+    double empty_weight;
+} HeuristicConfig;
+
+// 按配置生成的启发式表（不透明类型），创建后只读，可被多个搜索上下文共享
+typedef struct HeuristicTable HeuristicTable;
+
+// 填入默认权重
+void heuristic_config_init(HeuristicConfig* config);
+
+// 按名称设置一项权重（名称即字段名，如"sum_weight"），名称未知时返回false
+bool heuristic_config_set(HeuristicConfig* config, const char* name, double value);
+
+// 按名称读取一项权重，名称未知时返回false
+bool heuristic_config_get(const HeuristicConfig* config, const char* name, double* value);
+
+// 第index项权重的名称，index超出范围时返回NULL；用于遍历全部权重
+const char* heuristic_config_name(int index);
+
+// 从文件读取权重：每行"名称 = 值"，#开始的内容为注释，文件中未出现的权重保持不变。
+// 文件无法打开、名称未知或数值无效时返回false
+bool heuristic_config_load(HeuristicConfig* config, const char* path);
+
+// 把全部权重写入文件，格式与heuristic_config_load相同；失败时返回false
+bool heuristic_config_save(const HeuristicConfig* config, const char* path);
+
+// 按配置生成启发式表；定点格式下数值超出范围时返回NULL
+HeuristicTable* heuristic_table_create(const HeuristicConfig* config);
+void heuristic_table_destroy(HeuristicTable* table);
+
+// 生成该表所用的配置
+const HeuristicConfig* heuristic_table_config(const HeuristicTable* table);
+
+// 用指定的表评估棋盘，table为NULL时使用默认表，与score_heur_board相同
+double heuristic_table_score(const HeuristicTable* table, uint64_t board);
+
+#endif // GAME2048_HEURISTIC_H
@@ -0,0 +1,24 @@
+// game2048_log.c - 分级日志输出
+#include <stdio.h>
+#include <stdarg.h>
+#include "game2048_log.h"
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+void game2048_log_write(int level, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+
+#ifdef __ANDROID__
+    static const int priorities[] = {
+        ANDROID_LOG_SILENT, ANDROID_LOG_ERROR, ANDROID_LOG_WARN, ANDROID_LOG_INFO, ANDROID_LOG_DEBUG
+    };
+    int prio = (level >= GAME2048_LOG_ERROR && level <= GAME2048_LOG_DEBUG) ? priorities[level] : ANDROID_LOG_DEBUG;
+    __android_log_vprint(prio, "Game2048", fmt, args);
+#else
+    vfprintf(level <= GAME2048_LOG_WARN ? stderr : stdout, fmt, args);
+#endif
+
+    va_end(args);
+}
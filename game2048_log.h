@@ -0,0 +1,49 @@
+// game2048_log.h - 分级日志
+//
+// 日志级别在编译期由GAME2048_LOG_LEVEL决定，高于该级别的日志宏展开为空语句，
+// 参数不会被求值，热点路径上没有任何开销。默认只保留INFO及以上。
+// 桌面平台ERROR/WARN输出到stderr，其余输出到stdout；Android输出到logcat。
+#ifndef GAME2048_LOG_H
+#define GAME2048_LOG_H
+
+#define GAME2048_LOG_NONE 0
+#define GAME2048_LOG_ERROR 1
+#define GAME2048_LOG_WARN 2
+#define GAME2048_LOG_INFO 3
+#define GAME2048_LOG_DEBUG 4
+
+#ifndef GAME2048_LOG_LEVEL
+#define GAME2048_LOG_LEVEL GAME2048_LOG_INFO
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+void game2048_log_write(int level, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+#else
+void game2048_log_write(int level, const char* fmt, ...);
+#endif
+
+#if GAME2048_LOG_LEVEL >= GAME2048_LOG_ERROR
+#define LOG_ERROR(...) game2048_log_write(GAME2048_LOG_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#if GAME2048_LOG_LEVEL >= GAME2048_LOG_WARN
+#define LOG_WARN(...) game2048_log_write(GAME2048_LOG_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if GAME2048_LOG_LEVEL >= GAME2048_LOG_INFO
+#define LOG_INFO(...) game2048_log_write(GAME2048_LOG_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if GAME2048_LOG_LEVEL >= GAME2048_LOG_DEBUG
+#define LOG_DEBUG(...) game2048_log_write(GAME2048_LOG_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#endif // GAME2048_LOG_H
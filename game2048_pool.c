@@ -0,0 +1,303 @@
+// game2048_pool.c - 搜索用线程池实现（工作窃取调度）
+//
+// 每个线程拥有一个双端队列：本线程从底部压入和弹出任务（后进先出，
+// 保持局部性），空闲线程从其他队列的顶部窃取任务（先进先出，窃取到的
+// 通常是较大的子树）。thread_pool_run可以在任务内部嵌套调用，等待子任务
+// 期间调用线程会继续执行自己队列中或窃取来的任务，因此不会死锁。
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "game2048_pool.h"
+
+#define DEQUE_CAPACITY 1024             // 每个队列的任务容量（2的幂）
+#define WORKER_STACK_SIZE (4 << 20)     // 工作线程栈大小，嵌套等待会加深调用栈
+
+// 一组同时提交的任务，pending归零表示全部完成
+typedef struct {
+    atomic_int pending;
+} TaskGroup;
+
+typedef struct {
+    TaskFunc func;
+    void* arg;
+    TaskGroup* group;
+} Task;
+
+// 双端队列：[top, bottom) 为有效任务，下标按容量取模
+typedef struct {
+    pthread_mutex_t lock;
+    int top;
+    int bottom;
+    Task tasks[DEQUE_CAPACITY];
+} WorkDeque;
+
+struct ThreadPool {
+    int num_threads;            // 线程槽位数，槽位0留给外部调用线程
+    pthread_t* threads;         // 槽位1..num_threads-1对应的工作线程
+    int num_started;            // 成功创建的工作线程数
+    WorkDeque* deques;          // 每个槽位一个队列
+
+    atomic_int queued;          // 所有队列中的任务总数
+    atomic_int sleepers;        // 正在休眠的工作线程数
+    atomic_bool shutdown;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t sleep_cond;
+};
+
+// 当前线程所属的线程池和槽位
+static _Thread_local ThreadPool* tls_pool = NULL;
+static _Thread_local int tls_slot = 0;
+static _Thread_local unsigned tls_seed = 0;
+
+static bool deque_push(WorkDeque* dq, Task task) {
+    bool ok = false;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->bottom - dq->top < DEQUE_CAPACITY) {
+        dq->tasks[dq->bottom & (DEQUE_CAPACITY - 1)] = task;
+        dq->bottom++;
+        ok = true;
+    }
+    pthread_mutex_unlock(&dq->lock);
+
+    return ok;
+}
+
+// 本线程从底部弹出
+static bool deque_pop(WorkDeque* dq, Task* out) {
+    bool ok = false;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->bottom > dq->top) {
+        dq->bottom--;
+        *out = dq->tasks[dq->bottom & (DEQUE_CAPACITY - 1)];
+        ok = true;
+    }
+    if (dq->bottom == dq->top) {
+        dq->top = dq->bottom = 0;
+    }
+    pthread_mutex_unlock(&dq->lock);
+
+    return ok;
+}
+
+// 其他线程从顶部窃取
+static bool deque_steal(WorkDeque* dq, Task* out) {
+    bool ok = false;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->bottom > dq->top) {
+        *out = dq->tasks[dq->top & (DEQUE_CAPACITY - 1)];
+        dq->top++;
+        ok = true;
+    }
+    if (dq->bottom == dq->top) {
+        dq->top = dq->bottom = 0;
+    }
+    pthread_mutex_unlock(&dq->lock);
+
+    return ok;
+}
+
+// 取得一个任务：先查自己的队列，再从随机起点开始依次窃取
+static bool find_task(ThreadPool* pool, int slot, Task* out) {
+    if (deque_pop(&pool->deques[slot], out)) {
+        return true;
+    }
+
+    tls_seed = tls_seed * 1103515245u + 12345u;
+    int start = (int)((tls_seed >> 16) % (unsigned)pool->num_threads);
+    for (int i = 0; i < pool->num_threads; i++) {
+        int victim = (start + i) % pool->num_threads;
+        if (victim != slot && deque_steal(&pool->deques[victim], out)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// 执行一个任务，没有可执行任务时返回false
+static bool run_one_task(ThreadPool* pool, int slot) {
+    Task task;
+
+    if (atomic_load(&pool->queued) <= 0 || !find_task(pool, slot, &task)) {
+        return false;
+    }
+
+    atomic_fetch_sub(&pool->queued, 1);
+    task.func(task.arg);
+    atomic_fetch_sub(&task.group->pending, 1);
+    return true;
+}
+
+static void wake_workers(ThreadPool* pool) {
+    if (atomic_load(&pool->sleepers) > 0) {
+        pthread_mutex_lock(&pool->sleep_lock);
+        pthread_cond_broadcast(&pool->sleep_cond);
+        pthread_mutex_unlock(&pool->sleep_lock);
+    }
+}
+
+typedef struct {
+    ThreadPool* pool;
+    int slot;
+} WorkerArgs;
+
+static void* worker_main(void* arg) {
+    WorkerArgs args = *(WorkerArgs*)arg;
+    ThreadPool* pool = args.pool;
+    free(arg);
+
+    tls_pool = pool;
+    tls_slot = args.slot;
+    tls_seed = (unsigned)args.slot * 2654435761u;
+
+    while (!atomic_load(&pool->shutdown)) {
+        if (run_one_task(pool, args.slot)) {
+            continue;
+        }
+
+        // 没有任务时休眠，直到有新任务入队或线程池关闭
+        atomic_fetch_add(&pool->sleepers, 1);
+        pthread_mutex_lock(&pool->sleep_lock);
+        while (atomic_load(&pool->queued) <= 0 && !atomic_load(&pool->shutdown)) {
+            pthread_cond_wait(&pool->sleep_cond, &pool->sleep_lock);
+        }
+        pthread_mutex_unlock(&pool->sleep_lock);
+        atomic_fetch_sub(&pool->sleepers, 1);
+    }
+
+    return NULL;
+}
+
+ThreadPool* thread_pool_create(int num_threads) {
+    ThreadPool* pool = (ThreadPool*)calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+
+    pool->num_threads = num_threads > 1 ? num_threads : 1;
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->sleepers, 0);
+    atomic_init(&pool->shutdown, false);
+    pthread_mutex_init(&pool->sleep_lock, NULL);
+    pthread_cond_init(&pool->sleep_cond, NULL);
+
+    pool->deques = (WorkDeque*)calloc(pool->num_threads, sizeof(WorkDeque));
+    pool->threads = (pthread_t*)calloc(pool->num_threads, sizeof(pthread_t));
+    if (!pool->deques || !pool->threads) {
+        free(pool->deques);
+        free(pool->threads);
+        pthread_cond_destroy(&pool->sleep_cond);
+        pthread_mutex_destroy(&pool->sleep_lock);
+        free(pool);
+        return NULL;
+    }
+    for (int i = 0; i < pool->num_threads; i++) {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, WORKER_STACK_SIZE);
+    for (int i = 1; i < pool->num_threads; i++) {
+        WorkerArgs* args = (WorkerArgs*)malloc(sizeof(WorkerArgs));
+        if (!args) break;
+        args->pool = pool;
+        args->slot = i;
+        if (pthread_create(&pool->threads[pool->num_started], &attr, worker_main, args) != 0) {
+            free(args);
+            break;
+        }
+        pool->num_started++;
+    }
+    pthread_attr_destroy(&attr);
+
+    // 只保留已成功创建的线程（外加调用线程）
+    pool->num_threads = pool->num_started + 1;
+
+    return pool;
+}
+
+void thread_pool_destroy(ThreadPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->sleep_lock);
+    atomic_store(&pool->shutdown, true);
+    pthread_cond_broadcast(&pool->sleep_cond);
+    pthread_mutex_unlock(&pool->sleep_lock);
+
+    for (int i = 0; i < pool->num_started; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    for (int i = 0; i < pool->num_threads; i++) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+    }
+    pthread_cond_destroy(&pool->sleep_cond);
+    pthread_mutex_destroy(&pool->sleep_lock);
+    free(pool->deques);
+    free(pool->threads);
+    free(pool);
+}
+
+int thread_pool_size(ThreadPool* pool) {
+    return pool->num_threads;
+}
+
+void thread_pool_run(ThreadPool* pool, TaskFunc func, void* args, size_t arg_size, int count) {
+    if (count <= 0) return;
+
+    // 外部线程调用时临时占用槽位0
+    ThreadPool* prev_pool = tls_pool;
+    int prev_slot = tls_slot;
+    if (tls_pool != pool) {
+        tls_pool = pool;
+        tls_slot = 0;
+    }
+    int slot = tls_slot;
+
+    TaskGroup group;
+    atomic_init(&group.pending, count);
+
+    // 逆序压入，使本线程按下标顺序弹出执行；队列已满时直接在本线程执行
+    int pushed = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        Task task = { func, (char*)args + (size_t)i * arg_size, &group };
+        if (deque_push(&pool->deques[slot], task)) {
+            pushed++;
+        } else {
+            func(task.arg);
+            atomic_fetch_sub(&group.pending, 1);
+        }
+    }
+    atomic_fetch_add(&pool->queued, pushed);
+    wake_workers(pool);
+
+    // 等待期间帮助执行任务
+    while (atomic_load(&group.pending) > 0) {
+        if (!run_one_task(pool, slot)) {
+            sched_yield();
+        }
+    }
+
+    tls_pool = prev_pool;
+    tls_slot = prev_slot;
+}
+
+int thread_pool_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
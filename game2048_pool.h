@@ -0,0 +1,25 @@
+// game2048_pool.h - 搜索用线程池（工作窃取调度）
+#ifndef GAME2048_POOL_H
+#define GAME2048_POOL_H
+
+#include <stddef.h>
+
+// 任务函数，参数指向任务数组中的一个元素
+typedef void (*TaskFunc)(void* arg);
+
+typedef struct ThreadPool ThreadPool;
+
+// 创建线程池，num_threads为参与计算的线程总数（含调用线程）
+ThreadPool* thread_pool_create(int num_threads);
+void thread_pool_destroy(ThreadPool* pool);
+int thread_pool_size(ThreadPool* pool);
+
+// 并行执行count个任务：第i个任务的参数为 (char*)args + i * arg_size。
+// 调用线程同样参与执行，函数在全部任务完成后返回。
+// 可以在任务内部嵌套调用；同一时刻只允许一个外部线程调用
+void thread_pool_run(ThreadPool* pool, TaskFunc func, void* args, size_t arg_size, int count);
+
+// 当前机器可用的CPU核心数
+int thread_pool_cpu_count(void);
+
+#endif // GAME2048_POOL_H
@@ -0,0 +1,107 @@
+// game2048_rng.c - 落子用的随机数生成器（xoshiro256**）
+//
+// 生成器和跳跃多项式取自Blackman与Vigna的参考实现；有界整数用Lemire的
+// 乘法-拒绝法，平均每次调用约1次rng_next，只有极少数取值需要重抽。
+#include <stdbool.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "game2048_rng.h"
+
+uint64_t splitmix64_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t splitmix64_next(uint64_t* state) {
+    return splitmix64_mix(*state += 0x9E3779B97F4A7C15ULL);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+void rng_seed(Rng* rng, uint64_t seed) {
+    // splitmix64的输出不会连续四个为0，状态总是有效的
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64_next(&seed);
+    }
+}
+
+uint64_t rng_next(Rng* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+uint32_t rng_below(Rng* rng, uint32_t bound) {
+    // 取高32位（xoshiro256**的高位质量更好）乘以bound，积的高32位即结果；
+    // 低32位落在前(2^32 mod bound)个值中的结果会多出现一次，拒绝后重抽
+    uint64_t m = (rng_next(rng) >> 32) * (uint64_t)bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+        uint32_t threshold = (uint32_t)(-bound) % bound;
+        while (low < threshold) {
+            m = (rng_next(rng) >> 32) * (uint64_t)bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+double rng_double(Rng* rng) {
+    return (double)(rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void rng_jump(Rng* rng) {
+    static const uint64_t jump[] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & (1ULL << b)) {
+                s0 ^= rng->s[0];
+                s1 ^= rng->s[1];
+                s2 ^= rng->s[2];
+                s3 ^= rng->s[3];
+            }
+            rng_next(rng);
+        }
+    }
+    rng->s[0] = s0;
+    rng->s[1] = s1;
+    rng->s[2] = s2;
+    rng->s[3] = s3;
+}
+
+static _Thread_local Rng tls_rng;
+static _Thread_local bool tls_rng_seeded = false;
+
+Rng* rng_thread_default(void) {
+    if (!tls_rng_seeded) {
+#ifdef _WIN32
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        uint64_t seed = (uint64_t)counter.QuadPart ^ ((uint64_t)time(NULL) << 32);
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        uint64_t seed = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+        // 同一时刻启动的线程靠线程私有变量的地址区分
+        rng_seed(&tls_rng, seed ^ (uint64_t)(uintptr_t)&tls_rng);
+        tls_rng_seeded = true;
+    }
+    return &tls_rng;
+}
@@ -0,0 +1,37 @@
+// game2048_rng.h - 落子用的随机数生成器（xoshiro256**）
+//
+// 状态全部在Rng对象中，由调用方持有：同一种子在任何平台上产生同样的序列，
+// 每局、每个线程各用一个对象即可并行且可复现。
+#ifndef GAME2048_RNG_H
+#define GAME2048_RNG_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+// splitmix64：推进64位状态并返回下一个输出，用于播种和由棋盘派生的短序列
+uint64_t splitmix64_next(uint64_t* state);
+// splitmix64的终结函数，把相邻的输入映射为互不相关的输出
+uint64_t splitmix64_mix(uint64_t z);
+
+// 用64位种子初始化（经splitmix64扩展为256位状态，任何种子都可用）
+void rng_seed(Rng* rng, uint64_t seed);
+
+uint64_t rng_next(Rng* rng);
+
+// [0, bound)内的均匀整数，无取模偏差；bound必须大于0
+uint32_t rng_below(Rng* rng, uint32_t bound);
+
+// [0, 1)内的均匀浮点数，53位精度
+double rng_double(Rng* rng);
+
+// 前进2^128步，从一个种子分出互不重叠的子序列
+void rng_jump(Rng* rng);
+
+// 当前线程默认的生成器，首次使用时以时间和线程播种，结果不可复现；
+// 供没有自带生成器的调用方（add_random_tile、init_game）使用
+Rng* rng_thread_default(void);
+
+#endif // GAME2048_RNG_H
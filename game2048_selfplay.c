@@ -0,0 +1,167 @@
+// game2048_selfplay.c - 无界面批量自我对局命令行工具
+//
+// 用法: game2048_selfplay [-n 对局数] [-t 线程数] [-d 搜索深度] [-b 每步毫秒预算]
+//                         [-s 种子] [-m 单局步数上限] [-w 启发式配置]...
+//                         [-p exact|stochastic|legacy] [-k 抽样空位数] [-S] [-v]
+//   -b 大于0时使用限时搜索（结果与机器速度有关，不可复现），否则按固定深度搜索
+//   -p 机会节点的展开方式：exact枚举全部空位（默认），stochastic最多抽取-k个空位，
+//      legacy为旧版的步长采样（空位为7个时全部展开，8个及以上时不展开任何空位），用于比较质量和速度
+//   -w 从文件读取启发式权重（格式见game2048_heuristic.c），可重复给出多个，
+//      每个配置用同一组种子各下一遍，之后的配置逐局与第一个配置对比（A/B测试）
+//   -S 输出全部对局的搜索统计：各层节点数、截断次数、转置表命中和替换情况
+//   -v 逐局输出种子、得分、最大砖块和步数
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game2048.h"
+#include "game2048_batch.h"
+
+#define MAX_VARIANTS 8
+
+static void usage(const char* prog) {
+    fprintf(stderr, "用法: %s [-n 对局数] [-t 线程数] [-d 搜索深度] [-b 每步毫秒预算]\n", prog);
+    fprintf(stderr, "       [-s 种子] [-m 单局步数上限] [-w 启发式配置]...\n");
+    fprintf(stderr, "       [-p exact|stochastic|legacy] [-k 抽样空位数] [-S] [-v]\n");
+    fprintf(stderr, "  -p exact枚举全部空位（默认），stochastic最多抽取-k个空位，\n");
+    fprintf(stderr, "     legacy为旧版步长采样：空位为7个时全部展开，8个及以上时不展开任何空位\n");
+}
+
+// 同一组种子下variant与base逐局比较得分
+static void print_comparison(const GameResult* base, const GameResult* variant, int count) {
+    int wins = 0, ties = 0, losses = 0;
+    double diff_sum = 0;
+    for (int i = 0; i < count; i++) {
+        int diff = variant[i].score - base[i].score;
+        diff_sum += diff;
+        if (diff > 0) wins++;
+        else if (diff < 0) losses++;
+        else ties++;
+    }
+    printf("相对第一个配置: 平均得分差 %+.0f，逐局 胜%d 平%d 负%d\n", diff_sum / count, wins, ties, losses);
+}
+
+int main(int argc, char* argv[]) {
+    BatchConfig config;
+    bool verbose = false;
+    bool show_stats = false;
+    const char* variant_paths[MAX_VARIANTS];
+    int num_variants = 0;
+
+    batch_config_init(&config);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-S") == 0) {
+            show_stats = true;
+            continue;
+        }
+        if (argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0' || i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'n': config.num_games = atoi(value); break;
+            case 't': config.num_threads = atoi(value); break;
+            case 'd': config.depth_limit = atoi(value); break;
+            case 'b': config.budget_ms = atoi(value); break;
+            case 's': config.seed = strtoull(value, NULL, 0); break;
+            case 'm': config.max_moves = atoi(value); break;
+            case 'p':
+                if (strcmp(value, "exact") == 0) config.sample_mode = SAMPLE_EXACT;
+                else if (strcmp(value, "stochastic") == 0) config.sample_mode = SAMPLE_STOCHASTIC;
+                else if (strcmp(value, "legacy") == 0) config.sample_mode = SAMPLE_LEGACY;
+                else {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'k': config.max_samples = atoi(value); break;
+            case 'w':
+                if (num_variants == MAX_VARIANTS) {
+                    fprintf(stderr, "最多%d个启发式配置\n", MAX_VARIANTS);
+                    return 1;
+                }
+                variant_paths[num_variants++] = value;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (config.num_games < 1) {
+        fprintf(stderr, "对局数必须为正数\n");
+        return 1;
+    }
+
+    // 未给出-w时只跑默认权重
+    HeuristicTable* tables[MAX_VARIANTS] = { NULL };
+    int num_runs = num_variants > 0 ? num_variants : 1;
+    for (int v = 0; v < num_variants; v++) {
+        HeuristicConfig heuristic;
+        heuristic_config_init(&heuristic);
+        if (!heuristic_config_load(&heuristic, variant_paths[v]) ||
+            !(tables[v] = heuristic_table_create(&heuristic))) {
+            fprintf(stderr, "无法使用启发式配置 %s\n", variant_paths[v]);
+            for (int i = 0; i < v; i++) heuristic_table_destroy(tables[i]);
+            return 1;
+        }
+    }
+
+    GameResult* results = (GameResult*)calloc((size_t)config.num_games * num_runs, sizeof(GameResult));
+    if (!results) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+
+    if (config.budget_ms > 0) {
+        printf("自我对局: %d局，限时%dms/步，种子%llu\n",
+               config.num_games, config.budget_ms, (unsigned long long)config.seed);
+    } else {
+        printf("自我对局: %d局，深度%d，种子%llu\n",
+               config.num_games, config.depth_limit, (unsigned long long)config.seed);
+    }
+
+    int status = 0;
+    for (int v = 0; v < num_runs; v++) {
+        GameResult* run_results = results + (size_t)v * config.num_games;
+        if (num_variants > 0) {
+            printf("\n== 启发式配置 %s\n", variant_paths[v]);
+        }
+
+        config.heuristic = tables[v];
+        BatchSummary summary;
+        if (!run_batch(&config, run_results, &summary)) {
+            fprintf(stderr, "无法创建搜索上下文\n");
+            status = 1;
+            break;
+        }
+
+        if (verbose) {
+            for (int i = 0; i < config.num_games; i++) {
+                printf("第%d局 种子%016llx 得分%d 最大砖块%d 步数%d 用时%.2fs\n",
+                       i, (unsigned long long)run_results[i].seed, run_results[i].score,
+                       run_results[i].max_rank ? 1 << run_results[i].max_rank : 0,
+                       run_results[i].moves, run_results[i].seconds);
+            }
+        }
+        batch_print_summary(&summary);
+        if (show_stats) {
+            search_stats_print(&summary.stats);
+        }
+        if (v > 0) {
+            print_comparison(results, run_results, config.num_games);
+        }
+    }
+
+    free(results);
+    for (int v = 0; v < num_variants; v++) {
+        heuristic_table_destroy(tables[v]);
+    }
+    return status;
+}
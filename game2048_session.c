@@ -0,0 +1,276 @@
+// game2048_session.c - 按句柄管理的多局游戏
+//
+// 注册表是一个槽位数组，句柄由槽位下标（低32位）和槽位的代数（高32位）组成，
+// 销毁时代数加一，旧句柄随即失效。查找只持读锁，创建和销毁持写锁。
+// 会话带引用计数：查找时加一、调用结束时减一，注册表本身持有一个引用，
+// 销毁只是把会话移出注册表，最后一个引用释放时才真正释放内存。
+// 每个会话的状态由自己的锁保护，搜索在锁外进行。
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "game2048_session.h"
+#include "game2048_log.h"
+
+#define SESSION_INITIAL_SLOTS 16
+
+typedef struct {
+    atomic_int refs;
+    pthread_mutex_t lock;
+    GameState state;
+    Rng rng;                    // 落子的随机数生成器
+    size_t table_size;          // 后台搜索的转置表槽位数，0表示不能后台搜索
+    AsyncSearch* search;        // 后台搜索，首次使用时创建
+} Session;
+
+typedef struct {
+    Session* session;           // NULL表示空闲
+    uint32_t generation;
+    uint32_t next_free;         // 空闲槽位链表
+} SessionSlot;
+
+#define NO_FREE_SLOT UINT32_MAX
+
+static pthread_rwlock_t registry_lock = PTHREAD_RWLOCK_INITIALIZER;
+static SessionSlot* slots = NULL;
+static uint32_t num_slots = 0;
+static uint32_t free_head = NO_FREE_SLOT;
+static int live_sessions = 0;
+
+static GameSession make_handle(uint32_t index, uint32_t generation) {
+    return ((uint64_t)generation << 32) | index;
+}
+
+// 查找会话并加引用，句柄无效时返回NULL
+static Session* session_acquire(GameSession handle) {
+    uint32_t index = (uint32_t)handle;
+    uint32_t generation = (uint32_t)(handle >> 32);
+    Session* session = NULL;
+
+    pthread_rwlock_rdlock(&registry_lock);
+    if (index < num_slots && slots[index].session && slots[index].generation == generation) {
+        session = slots[index].session;
+        atomic_fetch_add(&session->refs, 1);
+    }
+    pthread_rwlock_unlock(&registry_lock);
+    return session;
+}
+
+static void session_release(Session* session) {
+    if (atomic_fetch_sub(&session->refs, 1) != 1) return;
+
+    async_search_destroy(session->search);
+    pthread_mutex_destroy(&session->lock);
+    free(session);
+}
+
+// 分配一个空闲槽位，调用时持有写锁
+static bool alloc_slot(uint32_t* index) {
+    if (free_head == NO_FREE_SLOT) {
+        uint32_t capacity = num_slots ? num_slots * 2 : SESSION_INITIAL_SLOTS;
+        if (capacity <= num_slots || capacity > NO_FREE_SLOT) return false;
+        SessionSlot* grown = (SessionSlot*)realloc(slots, capacity * sizeof(SessionSlot));
+        if (!grown) return false;
+        slots = grown;
+        // 新槽位按下标顺序接入空闲链表
+        for (uint32_t i = capacity; i-- > num_slots;) {
+            slots[i].session = NULL;
+            slots[i].generation = 1;
+            slots[i].next_free = free_head;
+            free_head = i;
+        }
+        num_slots = capacity;
+    }
+    *index = free_head;
+    free_head = slots[free_head].next_free;
+    return true;
+}
+
+GameSession session_create(uint64_t seed, size_t table_size) {
+    Session* session = (Session*)calloc(1, sizeof(Session));
+    if (!session) return GAME_SESSION_INVALID;
+    atomic_init(&session->refs, 1);
+    session->table_size = table_size;
+    pthread_mutex_init(&session->lock, NULL);
+    rng_seed(&session->rng, seed);
+    init_game_r(&session->state, &session->rng);
+
+    uint32_t index;
+    pthread_rwlock_wrlock(&registry_lock);
+    if (!alloc_slot(&index)) {
+        pthread_rwlock_unlock(&registry_lock);
+        LOG_ERROR("错误：无法分配会话槽位\n");
+        session_release(session);
+        return GAME_SESSION_INVALID;
+    }
+    slots[index].session = session;
+    GameSession handle = make_handle(index, slots[index].generation);
+    live_sessions++;
+    pthread_rwlock_unlock(&registry_lock);
+    return handle;
+}
+
+bool session_destroy(GameSession handle) {
+    uint32_t index = (uint32_t)handle;
+    uint32_t generation = (uint32_t)(handle >> 32);
+    Session* session = NULL;
+
+    pthread_rwlock_wrlock(&registry_lock);
+    if (index < num_slots && slots[index].session && slots[index].generation == generation) {
+        session = slots[index].session;
+        slots[index].session = NULL;
+        // 代数跳过0，保证句柄永不为GAME_SESSION_INVALID
+        if (++slots[index].generation == 0) slots[index].generation = 1;
+        slots[index].next_free = free_head;
+        free_head = index;
+        live_sessions--;
+    }
+    pthread_rwlock_unlock(&registry_lock);
+    if (!session) return false;
+
+    pthread_mutex_lock(&session->lock);
+    if (session->search) async_search_cancel(session->search);
+    pthread_mutex_unlock(&session->lock);
+    session_release(session);
+    return true;
+}
+
+int session_count(void) {
+    pthread_rwlock_rdlock(&registry_lock);
+    int count = live_sessions;
+    pthread_rwlock_unlock(&registry_lock);
+    return count;
+}
+
+bool session_reset(GameSession handle) {
+    Session* session = session_acquire(handle);
+    if (!session) return false;
+
+    pthread_mutex_lock(&session->lock);
+    if (session->search) async_search_cancel(session->search);
+    init_game_r(&session->state, &session->rng);
+    pthread_mutex_unlock(&session->lock);
+    session_release(session);
+    return true;
+}
+
+bool session_move(GameSession handle, int direction, bool* moved) {
+    Session* session = session_acquire(handle);
+    if (!session) return false;
+
+    bool changed = false;
+    pthread_mutex_lock(&session->lock);
+    GameState* state = &session->state;
+    switch (direction) {
+        case UP: changed = move_up(state); break;
+        case DOWN: changed = move_down(state); break;
+        case LEFT: changed = move_left(state); break;
+        case RIGHT: changed = move_right(state); break;
+    }
+    if (changed) {
+        state->board = add_random_tile_r(state->board, &session->rng);
+        state->game_over = is_game_over(state);
+        // 后台搜索的是旧棋盘，结果已无用
+        if (session->search) async_search_cancel(session->search);
+    }
+    pthread_mutex_unlock(&session->lock);
+    session_release(session);
+
+    if (moved) *moved = changed;
+    return true;
+}
+
+bool session_get_state(GameSession handle, GameState* out) {
+    Session* session = session_acquire(handle);
+    if (!session) return false;
+
+    pthread_mutex_lock(&session->lock);
+    *out = session->state;
+    pthread_mutex_unlock(&session->lock);
+    session_release(session);
+    return true;
+}
+
+int session_best_move(GameSession handle, SearchContext* ctx, int depth_limit) {
+    GameState state;
+    if (!session_get_state(handle, &state)) return -1;
+    return find_best_move_ctx(ctx, &state, depth_limit);
+}
+
+bool session_search_start(GameSession handle, int depth_limit, int budget_ms) {
+    Session* session = session_acquire(handle);
+    if (!session) return false;
+
+    bool started = false;
+    pthread_mutex_lock(&session->lock);
+    if (!session->search && session->table_size > 0) {
+        session->search = async_search_create(session->table_size);
+    }
+    if (session->search) {
+        started = async_search_start(session->search, session->state.board,
+                                     depth_limit, budget_ms, NULL, NULL);
+    }
+    pthread_mutex_unlock(&session->lock);
+    session_release(session);
+    return started;
+}
+
+AsyncSearchStatus session_search_poll(GameSession handle, int* move) {
+    Session* session = session_acquire(handle);
+    if (!session) return ASYNC_SEARCH_IDLE;
+
+    AsyncSearchStatus status = ASYNC_SEARCH_IDLE;
+    int result = -1;
+    uint64_t board = 0;
+    pthread_mutex_lock(&session->lock);
+    if (session->search) {
+        status = async_search_poll(session->search, &result, &board);
+        if (status == ASYNC_SEARCH_DONE && board != session->state.board) {
+            status = ASYNC_SEARCH_CANCELLED;
+        }
+    }
+    pthread_mutex_unlock(&session->lock);
+    session_release(session);
+
+    if (move) *move = status == ASYNC_SEARCH_DONE ? result : -1;
+    return status;
+}
+
+bool session_search_cancel(GameSession handle) {
+    Session* session = session_acquire(handle);
+    if (!session) return false;
+
+    pthread_mutex_lock(&session->lock);
+    if (session->search) async_search_cancel(session->search);
+    pthread_mutex_unlock(&session->lock);
+    session_release(session);
+    return true;
+}
+
+bool session_search_wait(GameSession handle) {
+    Session* session = session_acquire(handle);
+    if (!session) return false;
+
+    pthread_mutex_lock(&session->lock);
+    AsyncSearch* search = session->search;
+    pthread_mutex_unlock(&session->lock);
+    // 持有引用，后台搜索不会被释放；等待时不持锁，其他调用不受阻塞
+    if (search) async_search_wait(search);
+    session_release(session);
+    return true;
+}
+
+bool session_search_stats(GameSession handle, SearchStats* out) {
+    Session* session = session_acquire(handle);
+    if (!session) return false;
+
+    pthread_mutex_lock(&session->lock);
+    if (session->search) {
+        async_search_last_stats(session->search, out);
+    } else {
+        memset(out, 0, sizeof(*out));
+    }
+    pthread_mutex_unlock(&session->lock);
+    session_release(session);
+    return true;
+}
@@ -0,0 +1,53 @@
+// game2048_session.h - 按句柄管理的多局游戏
+//
+// 每局游戏（会话）有独立的棋盘、分数、随机数序列和后台搜索，通过不透明句柄访问。
+// 所有函数都可以在多个线程中同时调用，包括对同一局的调用；已销毁或无效的句柄
+// 使函数返回false（或-1），不会访问已释放的内存。调用前需先调用init_tables。
+#ifndef GAME2048_SESSION_H
+#define GAME2048_SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "game2048.h"
+#include "game2048_async.h"
+
+// 会话句柄，0表示无效；句柄销毁后不会再被复用
+typedef uint64_t GameSession;
+#define GAME_SESSION_INVALID 0
+
+#define SESSION_TABLE_SIZE (1 << 20)    // 桌面上会话后台搜索的建议转置表槽位数（约16MB）
+
+// 创建一局新游戏并落下两个初始砖块，同一种子产生同样的砖块序列；失败时返回GAME_SESSION_INVALID。
+// table_size为后台搜索的转置表期望槽位数：后台线程和转置表在首次session_search_start时才创建，
+// 会话销毁时释放；为0时会话不能后台搜索（只用session_best_move），不占用线程和转置表
+GameSession session_create(uint64_t seed, size_t table_size);
+// 销毁会话，取消其后台搜索；正在其他线程中进行的调用完成后才释放
+bool session_destroy(GameSession session);
+// 当前存在的会话数
+int session_count(void);
+
+// 重新开局，保留最高分，砖块序列接着原来的随机数继续
+bool session_reset(GameSession session);
+// 执行移动，棋盘改变时落下新砖块并更新游戏结束状态；moved可以为NULL
+bool session_move(GameSession session, int direction, bool* moved);
+// 读取棋盘、分数、最高分和游戏是否结束
+bool session_get_state(GameSession session, GameState* out);
+
+// 用调用方的搜索上下文同步搜索当前棋盘（不持有会话锁），返回方向，-1表示无法移动或句柄无效。
+// 多个线程各持一个上下文即可同时为不同会话搜索
+int session_best_move(GameSession session, SearchContext* ctx, int depth_limit);
+
+// 在会话自己的后台线程中搜索当前棋盘，参数含义同async_search_start；
+// 创建会话时table_size为0或无法创建后台搜索时返回false
+bool session_search_start(GameSession session, int depth_limit, int budget_ms);
+// 查询后台搜索，不阻塞；搜索期间棋盘已改变时结果作废，返回ASYNC_SEARCH_CANCELLED。
+// 句柄无效时返回ASYNC_SEARCH_IDLE
+AsyncSearchStatus session_search_poll(GameSession session, int* move);
+bool session_search_cancel(GameSession session);
+// 阻塞直到会话的后台搜索结束
+bool session_search_wait(GameSession session);
+// 最近一次后台搜索的统计，还没有搜索过时全部为0
+bool session_search_stats(GameSession session, SearchStats* out);
+
+#endif // GAME2048_SESSION_H
@@ -0,0 +1,215 @@
+// game2048_tables.h - 查表的存储格式和逐行生成
+//
+// 运行时初始化（game2048_core.c）、按配置生成启发式表（game2048_heuristic.c）和
+// 构建期生成器（game2048_gentables.c）共用这里的定义，保证得到完全相同的表。
+// 只含宏、类型和static inline函数，不需要链接。
+#ifndef GAME2048_TABLES_H
+#define GAME2048_TABLES_H
+
+#include <stdint.h>
+#include <math.h>
+#include "game2048.h"
+#include "game2048_heuristic.h"
+
+// 表的存储格式在编译期选择（见CMakeLists.txt），用精度换取更小的缓存占用：
+// GAME2048_HEUR_TABLE     启发式表：0 double（默认），1 float，2 定点int32
+// GAME2048_COMPACT_MOVES  1时走子表只存LEFT/RIGHT的16位行异或差，列方向运行时展开
+// GAME2048_PREBUILT_TABLES 1时使用构建期生成的game2048_tables_data.inc，不在启动时计算
+#ifndef GAME2048_HEUR_TABLE
+#define GAME2048_HEUR_TABLE 0
+#endif
+#ifndef GAME2048_COMPACT_MOVES
+#define GAME2048_COMPACT_MOVES 0
+#endif
+#ifndef GAME2048_PREBUILT_TABLES
+#define GAME2048_PREBUILT_TABLES 0
+#endif
+
+#if GAME2048_HEUR_TABLE == 1
+typedef float heur_t;
+#elif GAME2048_HEUR_TABLE == 2
+// 启发式值在[-2.7e6, 2.1e5]之间，9位小数时仍在int32范围内，精度约0.002
+#define HEUR_FIXED_SHIFT 9
+typedef int32_t heur_t;
+#else
+typedef double heur_t;
+#endif
+
+// 紧凑走子表每个方向的长度：末尾多留4项，供SIMD按8字节gather时越界读
+#define ROW_DELTA_STRIDE (ROW_MAX + 4)
+
+// 位操作辅助函数
+static inline uint64_t reverse_row(uint64_t row) {
+    return ((row >> 12) & 0xF) | ((row >> 4) & 0xF0) | ((row << 4) & 0xF00) | ((row << 12) & 0xF000);
+}
+
+static inline uint64_t unpack_col(uint64_t row) {
+    return ((row & 0xF) | ((row & 0xF0) << 12) |
+            ((row & 0xF00) << 24) | ((row & 0xF000) << 36));
+}
+
+// 默认权重，对应编译进引擎的默认启发式表
+#define HEURISTIC_CONFIG_DEFAULT { \
+    SCORE_LOST_PENALTY, SCORE_MONOTONICITY_POWER, SCORE_MONOTONICITY_WEIGHT, \
+    SCORE_SUM_POWER, SCORE_SUM_WEIGHT, SCORE_MERGES_WEIGHT, SCORE_EMPTY_WEIGHT }
+
+// 按配置预先算好的各等级幂次，逐行生成时只剩加减乘，结果与直接调用pow相同
+typedef struct {
+    double sum_pow[16];
+    double monotonicity_pow[16];
+} HeuristicPowers;
+
+// 按配置生成的启发式表
+struct HeuristicTable {
+    HeuristicConfig config;
+    heur_t values[ROW_MAX];
+};
+
+static inline void heuristic_powers_init(const HeuristicConfig* config, HeuristicPowers* powers) {
+    for (int rank = 0; rank < 16; rank++) {
+        powers->sum_pow[rank] = pow(rank, config->sum_power);
+        powers->monotonicity_pow[rank] = pow(rank, config->monotonicity_power);
+    }
+}
+
+// 一行的启发式得分（未转换存储格式）
+static inline double heuristic_row_value(unsigned row, const HeuristicConfig* config,
+                                         const HeuristicPowers* powers) {
+    unsigned line[4] = {
+        (row >> 0) & 0xf,
+        (row >> 4) & 0xf,
+        (row >> 8) & 0xf,
+        (row >> 12) & 0xf
+    };
+
+    double sum = 0;
+    int empty = 0;
+    int merges = 0;
+    unsigned prev = 0;
+    int counter = 0;
+
+    for (int i = 0; i < 4; i++) {
+        unsigned rank = line[i];
+        sum += powers->sum_pow[rank];
+        if (rank == 0) {
+            empty++;
+        } else {
+            if (prev == rank) {
+                counter++;
+            } else if (counter > 0) {
+                merges += 1 + counter;
+                counter = 0;
+            }
+            prev = rank;
+        }
+    }
+    if (counter > 0) merges += 1 + counter;
+
+    double monotonicity_left = 0, monotonicity_right = 0;
+    for (int i = 1; i < 4; i++) {
+        if (line[i-1] > line[i]) {
+            monotonicity_left += powers->monotonicity_pow[line[i-1]] - powers->monotonicity_pow[line[i]];
+        } else {
+            monotonicity_right += powers->monotonicity_pow[line[i]] - powers->monotonicity_pow[line[i-1]];
+        }
+    }
+
+    return config->lost_penalty +
+           config->empty_weight * empty +
+           config->merges_weight * merges -
+           config->monotonicity_weight * fmin(monotonicity_left, monotonicity_right) -
+           config->sum_weight * sum;
+}
+
+#if GAME2048_HEUR_TABLE == 2
+#define HEUR_FIXED_LIMIT ((double)INT32_MAX / (1 << HEUR_FIXED_SHIFT))
+#endif
+
+// 按存储格式转换启发式得分
+static inline heur_t heuristic_store_value(double heur) {
+#if GAME2048_HEUR_TABLE == 2
+    return (int32_t)lrint(heur * (1 << HEUR_FIXED_SHIFT));
+#else
+    return (heur_t)heur;
+#endif
+}
+
+// 棋盘四行的启发式得分之和
+static inline double heuristic_rows_score(const heur_t* table, uint64_t board) {
+#if GAME2048_HEUR_TABLE == 2
+    int64_t sum = (int64_t)table[(board >>  0) & ROW_MASK] +
+                  table[(board >> 16) & ROW_MASK] +
+                  table[(board >> 32) & ROW_MASK] +
+                  table[(board >> 48) & ROW_MASK];
+    return (double)sum * (1.0 / (1 << HEUR_FIXED_SHIFT));
+#else
+    return (double)table[(board >>  0) & ROW_MASK] +
+           (double)table[(board >> 16) & ROW_MASK] +
+           (double)table[(board >> 32) & ROW_MASK] +
+           (double)table[(board >> 48) & ROW_MASK];
+#endif
+}
+
+// 一行的查表结果
+typedef struct {
+    heur_t heur;            // 启发式得分（已按存储格式转换）
+    uint32_t score;         // 行得分，都是整数且小于2^21
+    uint64_t delta[4];      // 各方向移动前后的异或差，UP/DOWN为列展开形式
+} TableRow;
+
+// 向左移动一行，返回移动后的行
+static inline uint64_t table_row_move_left(uint64_t row) {
+    unsigned line[4] = {
+        (row >> 0) & 0xf,
+        (row >> 4) & 0xf,
+        (row >> 8) & 0xf,
+        (row >> 12) & 0xf
+    };
+
+    // 关键修改：合并逻辑限制到MAX_RANK (2048)
+    int i = 0;
+    while (i < 3) {
+        int j = i + 1;
+        while (j < 4 && line[j] == 0) j++;  // 跳过右侧空位
+        if (j == 4) break;  // 没有更多砖块
+
+        if (line[i] == 0) {  // 移动空位到左侧
+            line[i] = line[j];
+            line[j] = 0;
+            i--;  // 重新检查当前位置
+        } else if (line[i] == line[j] && line[i] < MAX_RANK) {  // 合并条件：相同且小于MAX_RANK
+            line[i]++;  // 合并后的等级+1（比如10->11）
+            line[j] = 0;  // 清除右侧砖块
+        }
+        i++;
+    }
+
+    return ((uint64_t)line[0] << 0) | ((uint64_t)line[1] << 4) |
+           ((uint64_t)line[2] << 8) | ((uint64_t)line[3] << 12);
+}
+
+// 生成一行的全部查表结果，启发式得分按config计算
+static inline void table_row_generate(unsigned row, const HeuristicConfig* config,
+                                      const HeuristicPowers* powers, TableRow* out) {
+    // 分数表计算
+    uint32_t score = 0;
+    for (int i = 0; i < 4; i++) {
+        unsigned rank = (row >> (4 * i)) & 0xf;
+        if (rank >= 2) {
+            score += (rank - 1) * (1 << rank);
+        }
+    }
+    out->score = score;
+
+    out->heur = heuristic_store_value(heuristic_row_value(row, config, powers));
+
+    // 向右移动等价于翻转、向左移动、再翻转；UP/DOWN是LEFT/RIGHT的列展开
+    uint64_t left = row ^ table_row_move_left(row);
+    uint64_t right = row ^ reverse_row(table_row_move_left(reverse_row(row)));
+    out->delta[LEFT] = left;
+    out->delta[RIGHT] = right;
+    out->delta[UP] = unpack_col(left);
+    out->delta[DOWN] = unpack_col(right);
+}
+
+#endif // GAME2048_TABLES_H
@@ -0,0 +1,479 @@
+// game2048_tt.c - 转置表实现：组相联的开放寻址表
+//
+// 每个桶恰好占用一个64字节缓存行，存放若干个槽位，整张表一次性分配，
+// 探测时只访问一个缓存行，插入时不再逐条malloc。
+// 表在多次搜索之间复用：每次搜索开始时推进代数，旧代条目在查找时视为未命中，
+// 并在插入时被优先覆盖，从而无需每步清空整张表。
+//
+// 三种并发方式：
+// - 串行：3路桶，key/score/depth/gen分开存放，不加锁
+// - 条带锁：与串行相同的布局，按桶分段加互斥锁
+// - 无锁：4路桶，每个槽位为两个64位原子字 {key^data, data}，
+//   data打包量化得分、深度和代数。读取时校验 key^data，
+//   并发写入造成的撕裂读会校验失败而被视为未命中，无需任何锁
+//
+// 桶下标默认用乘法移位哈希：key乘以2^64/φ后取高位，不需要除法，
+// 且只在低位几个格子上不同的棋盘也能均匀散开。也可切换为Zobrist哈希，
+// 但搜索不携带增量的哈希值，每次查找都要完整计算，只用于基准对比。
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "game2048_tt.h"
+#include "game2048_rng.h"
+
+#define TT_BUCKET_WAYS 3        // 串行/条带锁布局每个桶的槽位数
+#define TT_LF_WAYS 4            // 无锁布局每个桶的槽位数
+#define TT_BUCKET_BYTES 64      // 桶大小（一个缓存行）
+#define TT_LOCK_STRIPES 1024    // 条带锁数量（2的幂）
+
+// 无锁布局的得分量化：定点数保留8位小数，占data高48位
+#define TT_SCORE_SCALE 256.0
+#define TT_SCORE_LIMIT 5.0e11
+
+#define TT_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL    // 2^64 / 黄金分割比
+#define ZOBRIST_SEED 0x2048204820482048ULL
+
+typedef struct {
+    uint64_t key[TT_BUCKET_WAYS];       // 棋盘，0表示空槽（空棋盘不会进入搜索）
+    double score[TT_BUCKET_WAYS];       // 评估得分
+    uint8_t depth[TT_BUCKET_WAYS];      // 写入时的搜索深度
+    uint8_t gen[TT_BUCKET_WAYS];        // 写入时的代数
+    uint8_t pad[TT_BUCKET_BYTES - TT_BUCKET_WAYS * 18];
+} TransBucket;
+
+// data布局：[63:16]量化得分（有符号） [15:8]深度 [7:0]代数（非0）
+typedef struct {
+    _Atomic uint64_t check[TT_LF_WAYS];     // key ^ data，0表示空槽
+    _Atomic uint64_t data[TT_LF_WAYS];
+} LockFreeBucket;
+
+_Static_assert(sizeof(TransBucket) == TT_BUCKET_BYTES, "TransBucket必须占满一个缓存行");
+_Static_assert(sizeof(LockFreeBucket) == TT_BUCKET_BYTES, "LockFreeBucket必须占满一个缓存行");
+
+struct TransTable {
+    union {
+        TransBucket* buckets;           // 串行/条带锁布局
+        LockFreeBucket* lf_buckets;     // 无锁布局
+    };
+    void* raw;                  // 分配得到的原始指针，用于释放
+    size_t mask;                // 桶数-1，桶数为2的幂
+    unsigned shift;             // 64 - log2(桶数)
+    TTMode mode;
+    TTHash hash;
+    pthread_mutex_t* locks;     // 条带锁，仅TT_MODE_STRIPED时分配
+    uint8_t generation;         // 当前代数，取值1..255
+
+    bool stats_enabled;
+    _Atomic uint64_t probes;
+    _Atomic uint64_t hits;
+    _Atomic uint64_t inserts;
+    _Atomic uint64_t updates;
+    _Atomic uint64_t stale_replaced;
+    _Atomic uint64_t collisions;
+};
+
+// Zobrist键：zobrist_keys[格子][等级]，等级0（空格子）为0
+static uint64_t zobrist_keys[16][16];
+static pthread_once_t zobrist_once = PTHREAD_ONCE_INIT;
+
+static void init_zobrist_keys(void) {
+    uint64_t seed = ZOBRIST_SEED;
+
+    for (int pos = 0; pos < 16; pos++) {
+        zobrist_keys[pos][0] = 0;
+        for (int rank = 1; rank < 16; rank++) {
+            zobrist_keys[pos][rank] = splitmix64_next(&seed);
+        }
+    }
+}
+
+uint64_t zobrist_hash(uint64_t board) {
+    pthread_once(&zobrist_once, init_zobrist_keys);
+
+    uint64_t hash = 0;
+    for (int pos = 0; pos < 16; pos++) {
+        hash ^= zobrist_keys[pos][(board >> (4 * pos)) & 0xf];
+    }
+    return hash;
+}
+
+TransTable* create_trans_table(size_t size) {
+    TransTable* table = (TransTable*)calloc(1, sizeof(TransTable));
+    if (!table) return NULL;
+
+    // 至少两个桶，保证移位量小于64
+    size_t num_buckets = 2;
+    unsigned bits = 1;
+    while (num_buckets * 2 * TT_BUCKET_WAYS <= size) {
+        num_buckets *= 2;
+        bits++;
+    }
+
+    // 多分配一个缓存行用于手动对齐，calloc保证初始全部为空槽
+    table->raw = calloc(num_buckets + 1, TT_BUCKET_BYTES);
+    if (!table->raw) {
+        free(table);
+        return NULL;
+    }
+    table->buckets = (TransBucket*)(((uintptr_t)table->raw + TT_BUCKET_BYTES - 1) &
+                                    ~(uintptr_t)(TT_BUCKET_BYTES - 1));
+    table->mask = num_buckets - 1;
+    table->shift = 64 - bits;
+    table->mode = TT_MODE_SERIAL;
+    table->hash = TT_HASH_MULSHIFT;
+    table->locks = NULL;
+    table->generation = 1;
+    pthread_once(&zobrist_once, init_zobrist_keys);
+
+    return table;
+}
+
+static void clear_buckets(TransTable* table) {
+    memset(table->buckets, 0, (table->mask + 1) * TT_BUCKET_BYTES);
+}
+
+static void destroy_locks(TransTable* table) {
+    if (!table->locks) return;
+
+    for (int i = 0; i < TT_LOCK_STRIPES; i++) {
+        pthread_mutex_destroy(&table->locks[i]);
+    }
+    free(table->locks);
+    table->locks = NULL;
+}
+
+bool trans_table_set_mode(TransTable* table, TTMode mode) {
+    if (mode == table->mode) return true;
+
+    if (mode == TT_MODE_STRIPED) {
+        table->locks = (pthread_mutex_t*)malloc(TT_LOCK_STRIPES * sizeof(pthread_mutex_t));
+        if (!table->locks) return false;
+        for (int i = 0; i < TT_LOCK_STRIPES; i++) {
+            pthread_mutex_init(&table->locks[i], NULL);
+        }
+    } else {
+        destroy_locks(table);
+    }
+
+    // 无锁布局与其他两种布局不兼容，切换时清空
+    if (mode == TT_MODE_LOCKFREE || table->mode == TT_MODE_LOCKFREE) {
+        clear_buckets(table);
+        table->generation = 1;
+    }
+
+    table->mode = mode;
+    return true;
+}
+
+TTMode trans_table_mode(const TransTable* table) {
+    return table->mode;
+}
+
+void trans_table_set_hash(TransTable* table, TTHash hash) {
+    if (hash == table->hash) return;
+
+    // 条目的位置取决于哈希方式，切换后旧条目无法再被找到
+    clear_buckets(table);
+    table->generation = 1;
+    table->hash = hash;
+}
+
+// 乘法移位哈希：乘积的高位混合了key的所有位，取高shift位作为桶下标
+size_t hash_function(uint64_t key, unsigned shift) {
+    return (size_t)((key * TT_HASH_MULTIPLIER) >> shift);
+}
+
+static size_t bucket_index(const TransTable* table, uint64_t key) {
+    if (table->hash == TT_HASH_ZOBRIST) {
+        uint64_t hash = 0;
+        for (int pos = 0; pos < 16; pos++) {
+            hash ^= zobrist_keys[pos][(key >> (4 * pos)) & 0xf];
+        }
+        return (size_t)(hash >> table->shift);
+    }
+    return hash_function(key, table->shift);
+}
+
+#define TT_COUNT(table, counter) \
+    do { \
+        if ((table)->stats_enabled) \
+            atomic_fetch_add_explicit(&(table)->counter, 1, memory_order_relaxed); \
+    } while (0)
+
+// 判断并记录一次写入的类型：空槽、同一棋盘、旧代条目或当前代的其他棋盘
+static TTInsertResult count_insert(TransTable* table, bool empty, bool same, uint8_t gen) {
+    TTInsertResult result;
+    if (empty) {
+        result = TT_INSERT_EMPTY;
+        TT_COUNT(table, inserts);
+    } else if (same) {
+        result = TT_INSERT_UPDATE;
+        TT_COUNT(table, updates);
+    } else if (gen != table->generation) {
+        result = TT_INSERT_STALE;
+        TT_COUNT(table, stale_replaced);
+    } else {
+        result = TT_INSERT_COLLISION;
+        TT_COUNT(table, collisions);
+    }
+    return result;
+}
+
+static uint64_t pack_data(double score, int depth, uint8_t gen) {
+    if (score > TT_SCORE_LIMIT) score = TT_SCORE_LIMIT;
+    if (score < -TT_SCORE_LIMIT) score = -TT_SCORE_LIMIT;
+
+    double scaled = score * TT_SCORE_SCALE;
+    int64_t q = (int64_t)(scaled >= 0 ? scaled + 0.5 : scaled - 0.5);
+    return ((uint64_t)q << 16) | ((uint64_t)(uint8_t)depth << 8) | gen;
+}
+
+static double unpack_score(uint64_t data) {
+    return (double)((int64_t)data >> 16) / TT_SCORE_SCALE;
+}
+
+// 槽位的淘汰优先级：旧代条目越旧越优先，当前代条目的剩余深度越小（子树越浅、重算越便宜）越优先
+static int victim_rank(uint8_t gen, uint8_t depth, uint8_t generation) {
+    if (gen != generation) {
+        return 0x100 + (uint8_t)(generation - gen);
+    }
+    return 0xFF - depth;
+}
+
+static bool find_lockfree(TransTable* table, uint64_t key, TransEntry* out) {
+    LockFreeBucket* bucket = &table->lf_buckets[bucket_index(table, key)];
+
+    for (int i = 0; i < TT_LF_WAYS; i++) {
+        uint64_t data = atomic_load_explicit(&bucket->data[i], memory_order_relaxed);
+        uint64_t check = atomic_load_explicit(&bucket->check[i], memory_order_relaxed);
+        if ((check ^ data) == key && (uint8_t)data == table->generation) {
+            out->key = key;
+            out->depth = (uint8_t)(data >> 8);
+            out->score = unpack_score(data);
+            TT_COUNT(table, hits);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static TTInsertResult insert_lockfree(TransTable* table, uint64_t key, int depth, double score) {
+    LockFreeBucket* bucket = &table->lf_buckets[bucket_index(table, key)];
+    int victim = 0;
+    int best_rank = -1;
+    bool empty = false, same = false;
+    uint8_t victim_gen = 0;
+
+    // 读到的槽位可能正被其他线程改写，只影响淘汰选择，不影响正确性
+    for (int i = 0; i < TT_LF_WAYS; i++) {
+        uint64_t data = atomic_load_explicit(&bucket->data[i], memory_order_relaxed);
+        uint64_t check = atomic_load_explicit(&bucket->check[i], memory_order_relaxed);
+        if (check == 0 && data == 0) {
+            victim = i;
+            empty = true;
+            break;
+        }
+        if ((check ^ data) == key) {
+            victim = i;
+            same = true;
+            break;
+        }
+
+        int rank = victim_rank((uint8_t)data, (uint8_t)(data >> 8), table->generation);
+        if (rank >= best_rank) {
+            victim = i;
+            best_rank = rank;
+            victim_gen = (uint8_t)data;
+        }
+    }
+    TTInsertResult result = count_insert(table, empty, same, victim_gen);
+
+    uint64_t data = pack_data(score, depth, table->generation);
+    atomic_store_explicit(&bucket->check[victim], key ^ data, memory_order_relaxed);
+    atomic_store_explicit(&bucket->data[victim], data, memory_order_relaxed);
+    return result;
+}
+
+// 在转置表中查找，命中时填充out并返回true
+bool find_in_table(TransTable* table, uint64_t key, TransEntry* out) {
+    TT_COUNT(table, probes);
+    if (table->mode == TT_MODE_LOCKFREE) {
+        return find_lockfree(table, key, out);
+    }
+
+    size_t index = bucket_index(table, key);
+    TransBucket* bucket = &table->buckets[index];
+    bool found = false;
+
+    if (table->locks) pthread_mutex_lock(&table->locks[index & (TT_LOCK_STRIPES - 1)]);
+
+    for (int i = 0; i < TT_BUCKET_WAYS; i++) {
+        if (bucket->key[i] == key && bucket->gen[i] == table->generation) {
+            out->key = key;
+            out->depth = bucket->depth[i];
+            out->score = bucket->score[i];
+            found = true;
+            TT_COUNT(table, hits);
+            break;
+        }
+    }
+
+    if (table->locks) pthread_mutex_unlock(&table->locks[index & (TT_LOCK_STRIPES - 1)]);
+
+    return found;
+}
+
+// 向转置表中插入
+// 替换策略：已存在则原地更新；否则依次优先使用空槽、最旧的旧代槽位；
+// 全部为当前代时淘汰剩余深度最小（子树最浅）的槽位，深度相同时淘汰靠后的槽位。
+// 返回占用的槽位类型，供搜索统计使用
+TTInsertResult insert_to_table(TransTable* table, uint64_t key, int depth, double score) {
+    if (table->mode == TT_MODE_LOCKFREE) {
+        return insert_lockfree(table, key, depth, score);
+    }
+
+    size_t index = bucket_index(table, key);
+    TransBucket* bucket = &table->buckets[index];
+    int victim = 0;
+    int best_rank = -1;
+    bool empty = false, same = false;
+
+    if (table->locks) pthread_mutex_lock(&table->locks[index & (TT_LOCK_STRIPES - 1)]);
+
+    for (int i = 0; i < TT_BUCKET_WAYS; i++) {
+        if (bucket->key[i] == key) {
+            victim = i;
+            same = true;
+            break;
+        }
+        if (bucket->key[i] == 0) {
+            // 槽位按顺序填充，空槽之后不会再有已存在的条目
+            victim = i;
+            empty = true;
+            break;
+        }
+
+        int rank = victim_rank(bucket->gen[i], bucket->depth[i], table->generation);
+        if (rank >= best_rank) {
+            victim = i;
+            best_rank = rank;
+        }
+    }
+    TTInsertResult result = count_insert(table, empty, same, bucket->gen[victim]);
+
+    bucket->key[victim] = key;
+    bucket->depth[victim] = (uint8_t)depth;
+    bucket->gen[victim] = table->generation;
+    bucket->score[victim] = score;
+
+    if (table->locks) pthread_mutex_unlock(&table->locks[index & (TT_LOCK_STRIPES - 1)]);
+    return result;
+}
+
+// 开始新一代：之前写入的条目全部失效，但不触碰表内存。
+// 代数回绕时整表清零一次，避免255代之前的条目被误认为当前代
+void trans_table_new_generation(TransTable* table) {
+    table->generation++;
+    if (table->generation == 0) {
+        clear_buckets(table);
+        table->generation = 1;
+    }
+}
+
+void trans_table_enable_stats(TransTable* table, bool enable) {
+    table->stats_enabled = enable;
+    if (!enable) {
+        atomic_store(&table->probes, 0);
+        atomic_store(&table->hits, 0);
+        atomic_store(&table->inserts, 0);
+        atomic_store(&table->updates, 0);
+        atomic_store(&table->stale_replaced, 0);
+        atomic_store(&table->collisions, 0);
+    }
+}
+
+// 扫描整表统计占用情况，并读出访问计数；应在没有搜索进行时调用
+void trans_table_get_stats(TransTable* table, TransTableStats* out) {
+    memset(out, 0, sizeof(*out));
+    out->buckets = table->mask + 1;
+
+    if (table->mode == TT_MODE_LOCKFREE) {
+        out->slots = out->buckets * TT_LF_WAYS;
+        for (size_t b = 0; b <= table->mask; b++) {
+            LockFreeBucket* bucket = &table->lf_buckets[b];
+            int current = 0;
+            for (int i = 0; i < TT_LF_WAYS; i++) {
+                uint64_t data = atomic_load_explicit(&bucket->data[i], memory_order_relaxed);
+                uint64_t check = atomic_load_explicit(&bucket->check[i], memory_order_relaxed);
+                if (check == 0 && data == 0) continue;
+                out->used_slots++;
+                if ((uint8_t)data == table->generation) current++;
+            }
+            out->current_slots += current;
+            out->bucket_fill[current]++;
+        }
+    } else {
+        out->slots = out->buckets * TT_BUCKET_WAYS;
+        for (size_t b = 0; b <= table->mask; b++) {
+            TransBucket* bucket = &table->buckets[b];
+            int current = 0;
+            for (int i = 0; i < TT_BUCKET_WAYS; i++) {
+                if (bucket->key[i] == 0) continue;
+                out->used_slots++;
+                if (bucket->gen[i] == table->generation) current++;
+            }
+            out->current_slots += current;
+            out->bucket_fill[current]++;
+        }
+    }
+
+    out->probes = atomic_load(&table->probes);
+    out->hits = atomic_load(&table->hits);
+    out->inserts = atomic_load(&table->inserts);
+    out->updates = atomic_load(&table->updates);
+    out->stale_replaced = atomic_load(&table->stale_replaced);
+    out->collisions = atomic_load(&table->collisions);
+}
+
+void trans_table_print_stats(const TransTableStats* stats) {
+    printf("转置表: %zu个桶, %zu个槽位, 已占用%zu (%.1f%%), 当前代%zu (%.1f%%)\n",
+           stats->buckets, stats->slots,
+           stats->used_slots, 100.0 * stats->used_slots / stats->slots,
+           stats->current_slots, 100.0 * stats->current_slots / stats->slots);
+
+    printf("桶内当前代条目数分布:");
+    for (int i = 0; i < 5; i++) {
+        if (stats->bucket_fill[i] == 0 && i > 0) continue;
+        printf(" %d:%.1f%%", i, 100.0 * stats->bucket_fill[i] / stats->buckets);
+    }
+    printf("\n");
+
+    if (stats->probes > 0) {
+        uint64_t writes = stats->inserts + stats->updates + stats->stale_replaced + stats->collisions;
+        printf("查找%llu次, 命中%llu次 (%.1f%%)\n",
+               (unsigned long long)stats->probes, (unsigned long long)stats->hits,
+               100.0 * stats->hits / stats->probes);
+        printf("写入%llu次: 空槽%llu, 更新%llu, 覆盖旧代%llu, 冲突淘汰%llu (%.2f%%)\n",
+               (unsigned long long)writes,
+               (unsigned long long)stats->inserts, (unsigned long long)stats->updates,
+               (unsigned long long)stats->stale_replaced, (unsigned long long)stats->collisions,
+               writes ? 100.0 * stats->collisions / writes : 0.0);
+    }
+}
+
+void trans_table_clear(TransTable* table) {
+    clear_buckets(table);
+    table->generation = 1;
+}
+
+// 释放转置表，整表一次释放
+void free_trans_table(TransTable* table) {
+    if (!table) return;
+
+    destroy_locks(table);
+    free(table->raw);
+    free(table);
+}
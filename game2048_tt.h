@@ -0,0 +1,85 @@
+// game2048_tt.h - 转置表
+#ifndef GAME2048_TT_H
+#define GAME2048_TT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// 转置表的并发方式
+typedef enum {
+    TT_MODE_SERIAL = 0,         // 不加锁，仅限单线程；得分按double精确保存
+    TT_MODE_STRIPED,            // 条带互斥锁，作为并发基准
+    TT_MODE_LOCKFREE            // 无锁：键与数据异或校验，得分量化为定点数
+} TTMode;
+
+// 桶下标的哈希方式
+typedef enum {
+    TT_HASH_MULSHIFT = 0,       // 乘法移位（斐波那契哈希），默认
+    TT_HASH_ZOBRIST             // 16个格子×16个等级的Zobrist键异或，仅供game2048_bench hash对比
+} TTHash;
+
+typedef struct TransTable TransTable;
+
+// 一次写入占用的槽位
+typedef enum {
+    TT_INSERT_EMPTY = 0,        // 空槽
+    TT_INSERT_UPDATE,           // 原地更新同一棋盘
+    TT_INSERT_STALE,            // 覆盖旧代条目
+    TT_INSERT_COLLISION         // 桶满，淘汰当前代的其他棋盘
+} TTInsertResult;
+
+// 查表结果
+typedef struct {
+    uint64_t key;
+    int depth;
+    double score;
+} TransEntry;
+
+// 转置表统计：访问计数需先调用trans_table_enable_stats开启，占用情况每次扫描整表得出
+typedef struct {
+    size_t buckets;             // 桶数
+    size_t slots;               // 槽位总数
+    size_t used_slots;          // 已占用槽位（含旧代）
+    size_t current_slots;       // 当前代槽位
+    size_t bucket_fill[5];      // 含0..4个当前代槽位的桶数
+    uint64_t probes;            // 查找次数
+    uint64_t hits;              // 命中次数
+    uint64_t inserts;           // 写入空槽
+    uint64_t updates;           // 原地更新同一棋盘
+    uint64_t stale_replaced;    // 覆盖旧代条目
+    uint64_t collisions;        // 桶满时淘汰当前代的其他棋盘
+} TransTableStats;
+
+// 创建转置表，size为期望的槽位数，实际桶数向下取整到2的幂
+TransTable* create_trans_table(size_t size);
+void free_trans_table(TransTable* table);
+
+// 切换并发方式，只能在没有搜索进行时调用；切换存储布局时表被清空
+bool trans_table_set_mode(TransTable* table, TTMode mode);
+TTMode trans_table_mode(const TransTable* table);
+
+// 切换桶下标的哈希方式，表被清空。Zobrist方式每次查找都按棋盘完整计算哈希，
+// 比乘法移位慢，只用于比较两者的桶分布，搜索始终使用默认的乘法移位
+void trans_table_set_hash(TransTable* table, TTHash hash);
+
+// 计算key所在的桶下标，shift = 64 - log2(桶数)
+size_t hash_function(uint64_t key, unsigned shift);
+bool find_in_table(TransTable* table, uint64_t key, TransEntry* out);
+TTInsertResult insert_to_table(TransTable* table, uint64_t key, int depth, double score);
+
+// 开始新一代，之前写入的条目全部失效
+void trans_table_new_generation(TransTable* table);
+
+// 清空整张表，使之后的搜索结果不受之前内容影响（用于可复现的对局）
+void trans_table_clear(TransTable* table);
+
+// 统计：开启后每次查找/写入累加原子计数（有额外开销），关闭时计数清零
+void trans_table_enable_stats(TransTable* table, bool enable);
+void trans_table_get_stats(TransTable* table, TransTableStats* out);
+void trans_table_print_stats(const TransTableStats* stats);
+
+// 棋盘的Zobrist哈希（空格子贡献为0），与TT_HASH_ZOBRIST的桶下标所用的哈希相同
+uint64_t zobrist_hash(uint64_t board);
+
+#endif // GAME2048_TT_H
@@ -0,0 +1,390 @@
+// game2048_tune.c - 启发式权重调优工具
+//
+// 用法: game2048_tune [-a es|random] [-g 总代数] [-l 每代候选数] [-n 每个候选的对局数]
+//                     [-d 搜索深度] [-t 线程数] [-s 种子] [-S 初始步长]
+//                     [-w 初始配置] [-c 检查点文件] [-o 输出配置] [-r]
+//   -a es     简化的(μ/μ_w,λ)进化策略：按得分排序后取前一半候选加权重组为新的中心
+//      random 随机搜索：只在最好的候选胜过中心时移到该候选
+//   -g 总代数（含检查点中已完成的代），-r继续时用同一个值即可补完剩余的代
+//   -r 从检查点继续，算法、种子、候选数、对局数和深度以检查点为准
+//
+// 调优对象为单调性、总和、合并和空位的幂次与权重（lost_penalty保持不变）。
+// 各权重都为正数，在对数空间中采样：候选 = 中心 * exp(步长 * N(0,1))。
+// 每一代的中心和全部候选用同一组种子各下若干局固定深度的对局（公共随机数，
+// 差异只来自权重），以平均得分为适应度；对局经run_batch分配到所有CPU核心。
+// 若最好的候选胜过中心则步长增大，否则缩小。
+// 每代结束后原子地写入检查点（先写临时文件再改名）和当前中心的配置文件，
+// 中断后用-r继续，结果与不中断时完全相同；输出配置可直接用于game2048_selfplay -w。
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "game2048.h"
+#include "game2048_batch.h"
+#include "game2048_heuristic.h"
+
+#define MAX_CANDIDATES 64
+#define SIGMA_MIN 0.01
+#define SIGMA_MAX 1.0
+#define SIGMA_GROW 1.2
+#define SIGMA_SHRINK 0.85
+#define CHECKPOINT_LINE_MAX 256
+
+// 参与调优的权重
+static const char* tuned_names[] = {
+    "monotonicity_power", "monotonicity_weight",
+    "sum_power", "sum_weight",
+    "merges_weight", "empty_weight",
+};
+#define NUM_TUNED ((int)(sizeof(tuned_names) / sizeof(tuned_names[0])))
+
+typedef enum {
+    TUNE_ES,
+    TUNE_RANDOM
+} TuneAlgorithm;
+
+// 调优状态，整体写入检查点
+typedef struct {
+    TuneAlgorithm algorithm;
+    int generation;             // 已完成的代数
+    int candidates;             // 每代候选数λ
+    int games;                  // 每个候选的对局数
+    int depth;                  // 固定搜索深度
+    uint64_t seed;              // 基础种子，第g代的种子由它和g派生
+    uint64_t rng;               // 采样用随机数状态
+    double sigma;               // 对数空间中的步长
+    double center_score;        // 上一代中心的平均得分
+    HeuristicConfig center;
+} TuneState;
+
+// 标准正态分布（Box-Muller）
+static double gaussian(uint64_t* rng) {
+    double u1 = ((splitmix64_next(rng) >> 11) + 1.0) * (1.0 / 9007199254740993.0);   // (0, 1]
+    double u2 = (splitmix64_next(rng) >> 11) * (1.0 / 9007199254740992.0);           // [0, 1)
+    return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+static const char* algorithm_name(TuneAlgorithm algorithm) {
+    return algorithm == TUNE_ES ? "es" : "random";
+}
+
+// 以相同的种子下state->games局，返回平均得分；配置无效时返回-1
+static double evaluate(const TuneState* state, const HeuristicConfig* config, int threads,
+                       GameResult* results) {
+    HeuristicTable* table = heuristic_table_create(config);
+    if (!table) return -1;
+
+    BatchConfig batch;
+    batch_config_init(&batch);
+    batch.num_games = state->games;
+    batch.num_threads = threads;
+    batch.depth_limit = state->depth;
+    batch.seed = batch_game_seed(state->seed, state->generation);
+    batch.heuristic = table;
+
+    BatchSummary summary;
+    bool ok = run_batch(&batch, results, &summary);
+    heuristic_table_destroy(table);
+    return ok ? summary.score_mean : -1;
+}
+
+static double get_weight(const HeuristicConfig* config, const char* name) {
+    double value = 0;
+    heuristic_config_get(config, name, &value);
+    return value;
+}
+
+// 在中心附近采样一个候选
+static void sample_candidate(TuneState* state, HeuristicConfig* candidate) {
+    *candidate = state->center;
+    for (int i = 0; i < NUM_TUNED; i++) {
+        double value = get_weight(candidate, tuned_names[i]);
+        heuristic_config_set(candidate, tuned_names[i], value * exp(state->sigma * gaussian(&state->rng)));
+    }
+}
+
+// (μ/μ_w,λ)重组：按得分从高到低取前μ个候选，在对数空间中加权平均
+static void recombine(TuneState* state, const HeuristicConfig* candidates, const int* order, int count) {
+    int mu = count / 2 > 0 ? count / 2 : 1;
+    double weights[MAX_CANDIDATES];
+    double weight_sum = 0;
+    for (int k = 0; k < mu; k++) {
+        weights[k] = log(mu + 0.5) - log(k + 1.0);
+        weight_sum += weights[k];
+    }
+
+    for (int i = 0; i < NUM_TUNED; i++) {
+        double log_mean = 0;
+        for (int k = 0; k < mu; k++) {
+            log_mean += weights[k] / weight_sum * log(get_weight(&candidates[order[k]], tuned_names[i]));
+        }
+        heuristic_config_set(&state->center, tuned_names[i], exp(log_mean));
+    }
+}
+
+// 先写临时文件再改名，中途中断不会留下不完整的检查点
+static bool save_checkpoint(const TuneState* state, const char* path) {
+    char tmp_path[1024];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE* file = fopen(tmp_path, "w");
+    if (!file) return false;
+
+    fprintf(file, "# game2048_tune检查点，用 -r 继续\n");
+    fprintf(file, "algorithm = %s\n", algorithm_name(state->algorithm));
+    fprintf(file, "generation = %d\n", state->generation);
+    fprintf(file, "candidates = %d\n", state->candidates);
+    fprintf(file, "games = %d\n", state->games);
+    fprintf(file, "depth = %d\n", state->depth);
+    fprintf(file, "seed = %llu\n", (unsigned long long)state->seed);
+    fprintf(file, "rng = %llu\n", (unsigned long long)state->rng);
+    fprintf(file, "sigma = %.17g\n", state->sigma);
+    fprintf(file, "center_score = %.17g\n", state->center_score);
+    for (int i = 0; heuristic_config_name(i); i++) {
+        fprintf(file, "center.%s = %.17g\n", heuristic_config_name(i),
+                get_weight(&state->center, heuristic_config_name(i)));
+    }
+
+    if (fclose(file) != 0) return false;
+#ifdef _WIN32
+    // Windows的rename不覆盖已有文件
+    return MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(tmp_path, path) == 0;
+#endif
+}
+
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+static bool load_checkpoint(TuneState* state, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "无法打开检查点 %s\n", path);
+        return false;
+    }
+
+    char line[CHECKPOINT_LINE_MAX];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_no++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        char* text = trim(line);
+        if (*text == '\0') continue;
+
+        char* eq = strchr(text, '=');
+        if (!eq) {
+            ok = false;
+            break;
+        }
+        *eq = '\0';
+        char* key = trim(text);
+        char* value = trim(eq + 1);
+
+        if (strcmp(key, "algorithm") == 0) {
+            if (strcmp(value, "es") == 0) state->algorithm = TUNE_ES;
+            else if (strcmp(value, "random") == 0) state->algorithm = TUNE_RANDOM;
+            else ok = false;
+        } else if (strcmp(key, "generation") == 0) {
+            state->generation = atoi(value);
+        } else if (strcmp(key, "candidates") == 0) {
+            state->candidates = atoi(value);
+        } else if (strcmp(key, "games") == 0) {
+            state->games = atoi(value);
+        } else if (strcmp(key, "depth") == 0) {
+            state->depth = atoi(value);
+        } else if (strcmp(key, "seed") == 0) {
+            state->seed = strtoull(value, NULL, 0);
+        } else if (strcmp(key, "rng") == 0) {
+            state->rng = strtoull(value, NULL, 0);
+        } else if (strcmp(key, "sigma") == 0) {
+            state->sigma = strtod(value, NULL);
+        } else if (strcmp(key, "center_score") == 0) {
+            state->center_score = strtod(value, NULL);
+        } else if (strncmp(key, "center.", 7) == 0) {
+            ok = heuristic_config_set(&state->center, key + 7, strtod(value, NULL));
+        } else {
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    if (!ok) {
+        fprintf(stderr, "检查点 %s 第%d行无效\n", path, line_no);
+    }
+    return ok;
+}
+
+static void print_center(const TuneState* state) {
+    for (int i = 0; i < NUM_TUNED; i++) {
+        printf("  %-20s %.6g\n", tuned_names[i], get_weight(&state->center, tuned_names[i]));
+    }
+}
+
+// 跑一代：评估中心和全部候选，更新中心和步长
+static bool run_generation(TuneState* state, int threads, GameResult* results) {
+    HeuristicConfig candidates[MAX_CANDIDATES];
+    double scores[MAX_CANDIDATES];
+    int order[MAX_CANDIDATES];
+
+    double center_score = evaluate(state, &state->center, threads, results);
+    if (center_score < 0) {
+        fprintf(stderr, "无法评估当前中心的配置\n");
+        return false;
+    }
+
+    int best = -1;
+    for (int i = 0; i < state->candidates; i++) {
+        sample_candidate(state, &candidates[i]);
+        scores[i] = evaluate(state, &candidates[i], threads, results);
+        order[i] = i;
+        if (best < 0 || scores[i] > scores[best]) best = i;
+    }
+
+    // 按得分从高到低排序（候选数很少，插入排序即可）
+    for (int i = 1; i < state->candidates; i++) {
+        int current = order[i];
+        int j = i;
+        while (j > 0 && scores[order[j - 1]] < scores[current]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = current;
+    }
+
+    bool improved = scores[best] > center_score;
+    if (state->algorithm == TUNE_ES) {
+        recombine(state, candidates, order, state->candidates);
+    } else if (improved) {
+        state->center = candidates[best];
+    }
+
+    state->sigma *= improved ? SIGMA_GROW : SIGMA_SHRINK;
+    if (state->sigma < SIGMA_MIN) state->sigma = SIGMA_MIN;
+    if (state->sigma > SIGMA_MAX) state->sigma = SIGMA_MAX;
+    state->center_score = center_score;
+    state->generation++;
+
+    printf("第%d代: 中心平均得分 %.0f，最好候选 %.0f（%s），步长 %.3f\n",
+           state->generation, center_score, scores[best], improved ? "胜出" : "未胜出", state->sigma);
+    return true;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "用法: %s [-a es|random] [-g 总代数] [-l 每代候选数] [-n 每个候选的对局数]\n", prog);
+    fprintf(stderr, "       [-d 搜索深度] [-t 线程数] [-s 种子] [-S 初始步长]\n");
+    fprintf(stderr, "       [-w 初始配置] [-c 检查点文件] [-o 输出配置] [-r]\n");
+    fprintf(stderr, "  -g 为总代数，-r 继续时已完成的代计入其中\n");
+}
+
+int main(int argc, char* argv[]) {
+    TuneState state;
+    memset(&state, 0, sizeof(state));
+    state.algorithm = TUNE_ES;
+    state.candidates = 8;
+    state.games = 64;
+    state.depth = 2;
+    state.seed = 2048;
+    state.sigma = 0.2;
+    heuristic_config_init(&state.center);
+
+    int generations = 20;
+    int threads = 0;
+    bool resume = false;
+    const char* init_path = NULL;
+    const char* checkpoint_path = "tune.ckpt";
+    const char* output_path = "tune_best.cfg";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0) {
+            resume = true;
+            continue;
+        }
+        if (argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0' || i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'a':
+                if (strcmp(value, "es") == 0) state.algorithm = TUNE_ES;
+                else if (strcmp(value, "random") == 0) state.algorithm = TUNE_RANDOM;
+                else {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'g': generations = atoi(value); break;
+            case 'l': state.candidates = atoi(value); break;
+            case 'n': state.games = atoi(value); break;
+            case 'd': state.depth = atoi(value); break;
+            case 't': threads = atoi(value); break;
+            case 's': state.seed = strtoull(value, NULL, 0); break;
+            case 'S': state.sigma = atof(value); break;
+            case 'w': init_path = value; break;
+            case 'c': checkpoint_path = value; break;
+            case 'o': output_path = value; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (init_path && !heuristic_config_load(&state.center, init_path)) {
+        return 1;
+    }
+    if (resume && !load_checkpoint(&state, checkpoint_path)) {
+        return 1;
+    }
+    // 种子同时作为采样的随机数种子；继续时由检查点恢复
+    if (!resume) {
+        state.rng = state.seed;
+    }
+
+    if (state.candidates < 2 || state.candidates > MAX_CANDIDATES || state.games < 1 || state.depth < 1) {
+        fprintf(stderr, "候选数须在2..%d之间，对局数和深度须为正数\n", MAX_CANDIDATES);
+        return 1;
+    }
+
+    GameResult* results = (GameResult*)calloc(state.games, sizeof(GameResult));
+    if (!results) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+
+    printf("调优: 算法%s，每代%d个候选，每个%d局，深度%d，种子%llu，从第%d代开始\n",
+           algorithm_name(state.algorithm), state.candidates, state.games, state.depth,
+           (unsigned long long)state.seed, state.generation + 1);
+
+    int status = 0;
+    // 继续时只补完到总代数为止
+    while (state.generation < generations) {
+        if (!run_generation(&state, threads, results)) {
+            status = 1;
+            break;
+        }
+        if (!save_checkpoint(&state, checkpoint_path) || !heuristic_config_save(&state.center, output_path)) {
+            fprintf(stderr, "无法写入检查点 %s 或配置 %s\n", checkpoint_path, output_path);
+            status = 1;
+            break;
+        }
+    }
+
+    printf("当前中心（已写入%s）:\n", output_path);
+    print_center(&state);
+
+    free(results);
+    return status;
+}